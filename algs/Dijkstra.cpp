@@ -10,6 +10,7 @@ std::vector<edge_t> cav::Dijkstra::solve(std::vector<len_t>& ecosts, node_t src,
 
     node_t nnodes = inst.get_nodes_num();
     Q.reset();
+    Q.reset_stats();
     nodes.assign(nnodes, DijkNode(UNINIT_EDGE, 0));
 
     add_or_update_adj_nodes(ecosts, dst);
@@ -22,7 +22,12 @@ namespace cav {
             len_t dist;
         };
 
-        using NodePQueue = BinaryHeapPtr<DijkNode, &DijkNode::hidx, &DijkNode::dist>;
+#ifdef CAV_HEAP_STATS
+        using HeapStatsPolicy = CountHeapStats;
+#else
+        using HeapStatsPolicy = NoHeapStats;
+#endif
+        using NodePQueue = BinaryHeapPtr<DijkNode, &DijkNode::hidx, &DijkNode::dist, HeapStatsPolicy>;
         static constexpr edge_t UNINIT_EDGE = std::numeric_limits<edge_t>::max();
 
 
@@ -32,6 +37,9 @@ namespace cav {
         std::vector<edge_t> solve(std::vector<len_t>& ecosts, node_t src, node_t dst);
         inline std::vector<edge_t> operator()(std::vector<len_t>& ecosts, node_t src, node_t dst) { return solve(ecosts, src, dst); }
 
+        // Heap counters of the last solve (all zero unless compiled with CAV_HEAP_STATS).
+        inline HeapStats heap_stats() const { return Q.stats(); }
+
     private:
         std::vector<edge_t> make_path(node_t src, node_t dst);
         void add_or_update_adj_nodes(std::vector<len_t>& ecosts, node_t u);
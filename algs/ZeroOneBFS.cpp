@@ -0,0 +1,66 @@
+#include "ZeroOneBFS.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+/**
+ * Returns the shortest path between src and dst in symmetric graphs with 0/1 edge costs.
+ * */
+std::vector<edge_t> cav::ZeroOneBFS::solve(std::vector<len_t>& ecosts, node_t src, node_t dst) {
+
+    node_t nnodes = inst.get_nodes_num();
+    Q.clear();
+    nodes.assign(nnodes, BFSNode(UNINIT_EDGE, 0));
+    done.assign(nnodes, false);
+
+    done[dst] = true;
+    relax_adj_nodes(ecosts, dst);
+
+    while (!Q.empty()) {
+        node_t u = Q.pop_front();
+        if (done[u]) { continue; }  // stale copy, already extracted with a smaller distance
+        if (u == src) { return make_path(src, dst); }
+
+        done[u] = true;
+        relax_adj_nodes(ecosts, u);
+    }
+
+    return std::vector<edge_t>();
+}
+
+void cav::ZeroOneBFS::relax_adj_nodes(std::vector<len_t>& ecosts, node_t u) {
+
+    for (auto [n, _] : inst.get_adjacent(u)) {
+        if (done[n]) continue;
+
+        const std::vector<edge_t>& p_eids = inst.get_parallel_edges(u, n);
+        edge_t best_eid = *std::min_element(p_eids.begin(), p_eids.end(), [&ecosts](edge_t e1, edge_t e2) { return ecosts[e1] < ecosts[e2]; });
+
+        if (ecosts[best_eid] >= FORBIDDEN_LEN) continue;
+        assert(ecosts[best_eid] == 0 || ecosts[best_eid] == 1);
+
+        len_t curr_dist = nodes[u].dist + ecosts[best_eid];
+        if (nodes[n].edge == UNINIT_EDGE || nodes[n].dist > curr_dist) {
+            nodes[n] = BFSNode(best_eid, curr_dist);
+            if (ecosts[best_eid] == 0) {
+                Q.push_front(n);
+            } else {
+                Q.push_back(n);
+            }
+        }
+    }
+}
+
+std::vector<edge_t> cav::ZeroOneBFS::make_path(node_t src, node_t dst) {
+
+    std::vector<edge_t> path;
+    edge_t n = src;
+    do {
+        path.emplace_back(nodes[n].edge);
+        auto [a, b] = inst.get_nodes_of_edge(nodes[n].edge);
+        n = (n != a ? a : b);
+    } while (n != dst);
+
+    return path;
+}
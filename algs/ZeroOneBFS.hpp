@@ -0,0 +1,52 @@
+#ifndef CAV_ZEROONEBFS_HPP
+#define CAV_ZEROONEBFS_HPP
+#include <limits>
+#include <vector>
+
+#include "CircularVector.hpp"
+#include "Instance.hpp"
+#include "types.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Shortest path for graphs whose edge costs are only 0 or 1 (edges with cost >= FORBIDDEN_LEN are skipped).
+     * Same interface of Dijkstra, but the priority queue is replaced by a deque: 0-cost relaxations go to the front,
+     * 1-cost ones to the back, giving O(V + E) instead of O((V + E) log V).
+     */
+    class ZeroOneBFS {
+        //////////// MISH ////////////
+    public:
+        static constexpr len_t FORBIDDEN_LEN = 10e10;
+
+    private:
+        struct BFSNode {
+            BFSNode(edge_t edge_, len_t dist_) : edge(edge_), dist(dist_) { }
+            edge_t edge;
+            len_t dist;
+        };
+
+        static constexpr edge_t UNINIT_EDGE = std::numeric_limits<edge_t>::max();
+
+
+        //////////// METHODS ////////////
+    public:
+        ZeroOneBFS(const Instance& inst_) : inst(inst_) { }
+        std::vector<edge_t> solve(std::vector<len_t>& ecosts, node_t src, node_t dst);
+        inline std::vector<edge_t> operator()(std::vector<len_t>& ecosts, node_t src, node_t dst) { return solve(ecosts, src, dst); }
+
+    private:
+        std::vector<edge_t> make_path(node_t src, node_t dst);
+        void relax_adj_nodes(std::vector<len_t>& ecosts, node_t u);
+
+
+        //////////// FIELDS ////////////
+    private:
+        const Instance& inst;
+        std::vector<BFSNode> nodes;
+        std::vector<bool> done;
+        CircularVector<node_t> Q;
+    };
+}  // namespace cav
+
+#endif
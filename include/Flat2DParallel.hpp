@@ -0,0 +1,58 @@
+#ifndef CAV_FLAT2DPARALLEL_HPP
+#define CAV_FLAT2DPARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Flat2DVector.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Threaded tile iteration and transposes for Flat2DVector, kept out of the container header so that its users do not
+ * depend on the thread pool.
+ */
+
+namespace cav {
+
+    /**
+     * @brief Same as m.for_each_tile, but tiles are handed out to nthreads threads of the shared pool (f must be
+     * thread safe across tiles).
+     */
+    template <typename T, typename Alloc, typename Func>
+    void parallel_for_each_tile(const Flat2DVector<T, Alloc>& m, size_t tile_rows, size_t tile_cols, Func&& f,
+                                unsigned nthreads = default_thread_pool().concurrency()) {
+        const size_t rows = m.get_rows(), cols = m.get_cols();
+        const size_t trows = (rows + tile_rows - 1) / tile_rows;
+        const size_t tcols = (cols + tile_cols - 1) / tile_cols;
+        parallel_for_chunks(trows * tcols, nthreads, [&](size_t t) {
+            const size_t i0 = (t / tcols) * tile_rows;
+            const size_t j0 = (t % tcols) * tile_cols;
+            f(i0, std::min(i0 + tile_rows, rows), j0, std::min(j0 + tile_cols, cols));
+        });
+    }
+
+    template <typename T, typename Alloc>
+    auto _parallel_tiles(const Flat2DVector<T, Alloc>& m, unsigned nthreads) {
+        return [&m, nthreads](size_t tile_rows, size_t tile_cols, auto&& f) { parallel_for_each_tile(m, tile_rows, tile_cols, f, nthreads); };
+    }
+
+    /**
+     * @brief m.transpose() with the tiles spread over nthreads threads.
+     */
+    template <typename T, typename Alloc>
+    void parallel_transpose(Flat2DVector<T, Alloc>& m, unsigned nthreads = default_thread_pool().concurrency()) {
+        m.transpose(_parallel_tiles(m, nthreads));
+    }
+
+    /**
+     * @brief src.transpose_into(dst) with the tiles spread over nthreads threads.
+     */
+    template <typename T, typename Alloc>
+    void parallel_transpose_into(const Flat2DVector<T, Alloc>& src, Flat2DVector<T, Alloc>& dst,
+                                 unsigned nthreads = default_thread_pool().concurrency()) {
+        src.transpose_into(dst, _parallel_tiles(src, nthreads));
+    }
+
+}  // namespace cav
+
+#endif
@@ -1,164 +1,162 @@
-#include <fstream>
-#include <sstream>
+#ifndef CAV_GENERICPARSER_HPP
+#define CAV_GENERICPARSER_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
-static std::string get_next_nonempty_line(std::ifstream& input_file) {
-    std::string line;
-    std::getline(input_file, line);
-    while (line.empty()) { std::getline(input_file, line); }
-    return line;
-}
-
-template <typename T>
-struct DefaultStrToT {
-    T operator()(std::istringstream input_file) {
-        T res;
-        input_file >> res;
-        return res;
-    }
-};
+#include "MappedFile.hpp"
+#include "TspLibLexer.hpp"
 
-struct BaseToken {
-    bool has_value;
-    virtual bool try_parse(std::ifstream& input_file);
+// Values parsed so far that the following keys depend on (sections are sized by the DIMENSION).
+struct ParseState {
+    int dimension = 0;
+    bool has_dimension = false;
 };
 
-template <typename T, class GetKeyAndValue>
-class Token : public BaseToken {
+/**
+ * @brief Key -> sink table, sorted by key so each key of the file is dispatched with a binary search.
+ * A sink is a plain function that reads the value of its key from the lexer and stores it into a bound destination.
+ */
+class KeyTable {
 public:
-    Token(std::string_view key_, T& dest_) : BaseToken(key_), dest(dest_), has_value(false) { }
-    inline T& get_dest() const { return dest; }
-
-    inline bool try_parse(std::ifstream& input_file) override {
-        auto pos = input_file.tellg();
-        auto [k, t] = GetKeyAndValue()(input_file);
-        if (k != key) {
-            input_file.seekg(pos);
-            return false;
+    using ParseFn = void (*)(cav::TspLibLexer& lex, void* dest, ParseState& state);
+
+    struct Entry {
+        std::string_view key;
+        ParseFn parse;
+        void* dest;
+    };
+
+    // Add (or replace) the sink of key. The key must outlive the table (e.g., a string literal).
+    void bind(std::string_view key, ParseFn parse, void* dest) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, std::string_view k) { return e.key < k; });
+        if (it != entries.end() && it->key == key) {
+            *it = {key, parse, dest};
+        } else {
+            entries.insert(it, {key, parse, dest});
         }
-        has_value = true;
-        dest = t;
-        return true;
     }
 
-private:
-    std::string key;
-    T& dest;
-};
-
-template <typename T, class GetKeyAndValue>
-class TokenDependent : public Token<T, GetKeyAndValue> {
-public:
-    TokenDependent(std::string_view key_, T& dest_, BaseToken& master_) : Token<T, GetKeyAndValue>(key_, dest_), master(master_) { }
-
-    inline bool try_parse(std::ifstream& input_file) override {
-        if (!sizeTok.has_value) { return false; }
-        return Token<T, GetKeyAndValue>(input_file);
+    inline const Entry* find(std::string_view key) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, std::string_view k) { return e.key < k; });
+        return it != entries.end() && it->key == key ? &*it : nullptr;
     }
 
-protected:
-    BaseToken& master;
+private:
+    std::vector<Entry> entries;
 };
 
-template <typename T, class GetKey, class GetT>
-class TokenDependentSeq : public TokenDependent<T*, GetT> {
-public:
-    TokenDependentSeq(std::string_view key_, T*& dest_, BaseToken& sizeTok_, size_t* size_) : TokenDependent<T*, GetT>(key_, dest_, sizeTok_), size(size_) {
-        dest = nullptr;
-    }
-
-    inline bool try_parse(std::ifstream& input_file) override {
-        if (!master.has_value) { return false; }
-
-        auto pos = input_file.tellg();
-        if (GetKey()(input_file) != key) {
-            input_file.seekg(pos);
-            return false;
-        }
 
-        assert(dest == nullptr);
-        dest = new T[size];
-        has_value = true;
+///////// TYPED SINKS /////////
+template <typename T>
+void parse_value_sink(cav::TspLibLexer& lex, void* dest, ParseState&) {
+    *static_cast<T*>(dest) = lex.value<T>();
+}
 
-        for (size_t i = 0; i < size; ++i) { dest[i] = GetT()(input_file, dest[i]); }
-        return true;
-    }
+inline void parse_string_sink(cav::TspLibLexer& lex, void* dest, ParseState&) { *static_cast<std::string*>(dest) = lex.line_value(); }
 
-private:
-    size_t* size;
-};
+inline void parse_dimension_sink(cav::TspLibLexer& lex, void* dest, ParseState& state) {
+    state.dimension = lex.value<int>();
+    if (state.dimension < 0) { _throw(std::runtime_error("Error: negative DIMENSION.")); }
+    state.has_dimension = true;
+    if (dest != nullptr) { *static_cast<int*>(dest) = state.dimension; }
+}
 
 template <typename T>
-struct TspLibKeyValue {
-    auto operator()(std::istringstream input_file) {
-        std::string key;
-        std::string colon;
-        T val;
-        input_file >> key >> colon >> val;
-        return std::make_pair(key, val);
-    }
-};
+inline void parse_section_elem(cav::TspLibLexer& lex, T& elem) {
+    elem = lex.value<T>();
+}
 
-struct TspLibKey {
-    auto operator()(std::istringstream input_file) {
-        std::string key;
-        std::string colon;
-        input_file >> key >> colon;
-        return key;
-    }
-};
+template <typename T1, typename T2>
+inline void parse_section_elem(cav::TspLibLexer& lex, std::pair<T1, T2>& elem) {
+    elem.first = lex.value<T1>();
+    elem.second = lex.value<T2>();
+}
 
+// DIMENSION lines of "id values...", stored at position id-1 of a vector preallocated with DIMENSION elements.
 template <typename T>
-struct TspLibValue {
-    auto operator()(std::istringstream input_file) {
-        T val;
-        input_file >> val;
-        return val;
+void parse_section_sink(cav::TspLibLexer& lex, void* dest, ParseState& state) {
+    if (!state.has_dimension) { _throw(std::runtime_error("Error: section found before DIMENSION.")); }
+
+    auto& vec = *static_cast<std::vector<T>*>(dest);
+    vec.resize(state.dimension);
+    T* data = vec.data();
+    for (int i = 0; i < state.dimension; ++i) {
+        const int idx = lex.value<int>() - 1;
+        if (idx < 0 || idx >= state.dimension) { _throw(std::runtime_error("Error: node index out of range at byte " + std::to_string(lex.offset()))); }
+        parse_section_elem(lex, data[idx]);
     }
-};
-
-class TspLibParser : public std::vector<BaseToken*> {
-
-    void bind_NAME(std::string& dest) { add_token("NAME", dest); }
-    void bind_COMMENT(std::string& dest) { add_token("COMMENT", dest); }
-    void bind_TYPE(std::string& dest) { add_token("TYPE", dest); }
-    void bind_DIMENSION(int& dest) { add_token("DIMENSION", dest); }
-    void bind_EDGE_WEIGHT_TYPE(std::string& dest) { add_token("EDGE_WEIGHT_TYPE", dest); }
-    void bind_CAPACITY(double& dest) { add_token("CAPACITY", dest); }
-    void bind_DISTANCE(double& dest) { add_token("DISTANCE", dest); }
-    void bind_SERVICE_TIME(double& dest) { add_token("SERVICE_TIME", dest); }
+}
 
-    void bind_NODE_COORD_SECTION(std::pair<double, double>*& dest) { add_token("NODE_COORD_SECTION", dest); }
-    void bind_DEMAND_SECTION(double*& dest) { add_token("DEMAND_SECTION", dest); }
-    void bind_DEPOT_SECTION(int& dest) { add_token("DEPOT_SECTION", dest); }
+// List of node ids terminated by -1, only the first one is kept.
+inline void parse_depot_sink(cav::TspLibLexer& lex, void* dest, ParseState&) {
+    int& depot = *static_cast<int*>(dest);
+    depot = lex.value<int>();
+    for (int id = depot; id != -1; id = lex.value<int>()) { }
+}
 
-private:
-    template <typename T>
-    void add_token(std::string key, T& dest) {
-        push_back(new Token<T, TspLibKeyValue<T>>(key, dest));
+/**
+ * @brief Parse filepath dispatching each key through table. Keys without a sink are skipped (one line at a time, so
+ * unbound sections are skipped too), parsing stops at EOF.
+ */
+inline void generic_parser(const std::string& filepath, const KeyTable& table, ParseState& state) {
+    const auto file = cav::MappedFile(filepath);
+    auto lex = cav::TspLibLexer(file.view());
+
+    std::string_view key;
+    while (lex.next_key(key)) {
+        if (key == "EOF") { break; }
+
+        const KeyTable::Entry* sink = table.find(key);
+        if (sink == nullptr) {
+            lex.skip_line();
+            continue;
+        }
+        sink->parse(lex, sink->dest, state);
     }
+}
 
-    template <typename T>
-    void add_seq_token(std::string key, T*& dest) {
-        push_back(new TokenDependentSeq<T, TspLibKey, TspLibValue<T>>(key, dest));
+/**
+ * @brief TSPLIB (and CVRPLIB) reader: bind the wanted fields, then parse the file. Keys that are not bound are skipped.
+ *
+ *      TspLibParser parser;
+ *      parser.bind_NAME(name);
+ *      parser.bind_NODE_COORD_SECTION(coords);
+ *      parser.parse(path);
+ */
+class TspLibParser {
+public:
+    TspLibParser() { table.bind("DIMENSION", parse_dimension_sink, nullptr); }
+
+    void bind_NAME(std::string& dest) { table.bind("NAME", parse_string_sink, &dest); }
+    void bind_COMMENT(std::string& dest) { table.bind("COMMENT", parse_string_sink, &dest); }
+    void bind_TYPE(std::string& dest) { table.bind("TYPE", parse_string_sink, &dest); }
+    void bind_DIMENSION(int& dest) { table.bind("DIMENSION", parse_dimension_sink, &dest); }
+    void bind_EDGE_WEIGHT_TYPE(std::string& dest) { table.bind("EDGE_WEIGHT_TYPE", parse_string_sink, &dest); }
+    void bind_CAPACITY(double& dest) { table.bind("CAPACITY", parse_value_sink<double>, &dest); }
+    void bind_DISTANCE(double& dest) { table.bind("DISTANCE", parse_value_sink<double>, &dest); }
+    void bind_SERVICE_TIME(double& dest) { table.bind("SERVICE_TIME", parse_value_sink<double>, &dest); }
+
+    void bind_NODE_COORD_SECTION(std::vector<std::pair<double, double>>& dest) {
+        table.bind("NODE_COORD_SECTION", parse_section_sink<std::pair<double, double>>, &dest);
     }
-};
+    void bind_DEMAND_SECTION(std::vector<double>& dest) { table.bind("DEMAND_SECTION", parse_section_sink<double>, &dest); }
+    void bind_DEPOT_SECTION(int& dest) { table.bind("DEPOT_SECTION", parse_depot_sink, &dest); }
 
+    void parse(const std::string& filepath) {
+        state = ParseState();
+        generic_parser(filepath, table, state);
+    }
 
-void generic_parser(std::string filepath, std::vector<BaseToken*>& tokens) {
-    std::ifstream input_file(filepath);
-    if (input_file.is_open()) {
-        while (input_file.good()) {
-
-            for (BaseToken* bt : tokens) {
-                if (bt->try_parse(input_file)) { goto __break_and_continue__; }
-            }
+    inline int get_dimension() const { return state.dimension; }
 
-            throw std::string("Error while parsing line " + get_next_nonempty_line(input_file));
+private:
+    KeyTable table;
+    ParseState state;
+};
 
-        __break_and_continue__:;
-        }
-    } else
-        throw std::invalid_argument("Impossible to open instance file: " + filepath);
-}
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#ifndef CAV_MAPPEDFILE_HPP
+#define CAV_MAPPEDFILE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "MmapAllocator.hpp"
+#include "NonCopyable.hpp"
+#include "noexception.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Read-only memory mapping of a whole file (POSIX only), seen as a string_view.
+     * Used by the parsers to scan an instance in a single pass without copying it into std::string lines.
+     */
+    class MappedFile : private NonCopyable<MappedFile> {
+    public:
+        explicit MappedFile(const std::string& path, MmapAdvice advice = MmapAdvice::Sequential) {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) { _throw(std::runtime_error("Error: impossible to open file " + path)); }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                _throw(std::runtime_error("Error: fstat failed on " + path));
+            }
+
+            bytes = static_cast<size_t>(st.st_size);
+            if (bytes > 0) {
+                void* ptr = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (ptr == MAP_FAILED) {
+                    close(fd);
+                    _throw(std::runtime_error("Error: mmap failed on " + path));
+                }
+                madvise(ptr, bytes, advice == MmapAdvice::Random ? MADV_RANDOM : advice == MmapAdvice::Sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+                data = static_cast<const char*>(ptr);
+            }
+            close(fd);  // the mapping keeps its own reference to the file
+        }
+
+        MappedFile(MappedFile&& other) noexcept : data(std::exchange(other.data, nullptr)), bytes(std::exchange(other.bytes, 0)) { }
+
+        ~MappedFile() {
+            if (data != nullptr) { munmap(const_cast<char*>(data), bytes); }
+        }
+
+        inline std::string_view view() const { return std::string_view(data, bytes); }
+        inline size_t size() const { return bytes; }
+
+    private:
+        const char* data = nullptr;
+        size_t bytes = 0;
+    };
+
+}  // namespace cav
+
+#endif
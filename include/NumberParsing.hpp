@@ -0,0 +1,128 @@
+#ifndef CAV_NUMBERPARSING_HPP
+#define CAV_NUMBERPARSING_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "StringUtils.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Outcome of a batch conversion.
+     * ptr is the first char not consumed, so a buffer can be streamed by calling again on [ptr, end). ec is errc() if
+     * the conversion stopped because out was full or the input ended, invalid_argument if it stopped at a token that
+     * is not a number and result_out_of_range if a number does not fit the output type.
+     */
+    struct ParseNumbersResult {
+        size_t count;
+        const char* ptr;
+        std::errc ec;
+    };
+
+    static inline const char* skip_spaces(const char* p, const char* end) {
+        while (p != end && SPACES_SET(*p)) { ++p; }
+        return p;
+    }
+
+    ///////// SWAR DIGITS /////////
+    static constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+
+    // Number of leading decimal digits in the 8 bytes of word (first char in the lowest byte); digits become 0..9.
+    static inline int _swar_digits(uint64_t& word) {
+        word ^= 0x30 * SWAR_ONES;  // '0'..'9' -> 0..9
+        // High bit set in each byte >= 10. Carries only move towards later bytes, so the first flagged byte is exact.
+        const uint64_t non_digit = ((word + 0x76 * SWAR_ONES) | word) & (0x80 * SWAR_ONES);
+        return non_digit == 0 ? 8 : __builtin_ctzll(non_digit) / 8;
+    }
+
+    // Value of ndigits (1..8) digits laid out as by _swar_digits, with 3 multiplications.
+    static inline uint32_t _swar_value(uint64_t word, int ndigits) {
+        word <<= 8 * (8 - ndigits);  // the missing digits become leading zeros
+        word = word * 10 + (word >> 8);
+        word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        return static_cast<uint32_t>(word);
+    }
+
+    static constexpr uint64_t POW10[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL};
+
+    /**
+     * @brief One unsigned integer starting at p, 8 digits per step when at least 16 bytes are readable, from_chars
+     * otherwise (or for numbers longer than 16 digits).
+     */
+    template <typename UInt>
+    static inline std::from_chars_result parse_uint(const char* p, const char* end, UInt& out) {
+        static_assert(std::is_unsigned_v<UInt>);
+
+        if (end - p >= 16) {
+            uint64_t lo, hi;
+            std::memcpy(&lo, p, 8);
+            const int nlo = _swar_digits(lo);
+            if (nlo == 0) { return {p, std::errc::invalid_argument}; }
+
+            uint64_t value = _swar_value(lo, nlo);
+            int ndigits = nlo;
+            if (nlo == 8) {
+                std::memcpy(&hi, p + 8, 8);
+                const int nhi = _swar_digits(hi);
+                if (nhi == 8) { return std::from_chars(p, end, out); }  // more than 16 digits
+                if (nhi > 0) { value = value * POW10[nhi] + _swar_value(hi, nhi); }
+                ndigits += nhi;
+            }
+
+            if (ndigits > std::numeric_limits<UInt>::digits10 && value > std::numeric_limits<UInt>::max()) {
+                return {p + ndigits, std::errc::result_out_of_range};
+            }
+            out = static_cast<UInt>(value);
+            return {p + ndigits, std::errc()};
+        }
+        return std::from_chars(p, end, out);
+    }
+
+    /**
+     * @brief Parse up to max_count unsigned integers separated by SPACES from s into out.
+     */
+    template <typename UInt>
+    static inline ParseNumbersResult parse_uints(std::string_view s, UInt* out, size_t max_count) {
+        const char* p = s.data();
+        const char* end = s.data() + s.size();
+        size_t count = 0;
+        while (count < max_count) {
+            p = skip_spaces(p, end);
+            if (p == end) { break; }
+            const auto [ptr, ec] = parse_uint(p, end, out[count]);
+            if (ec != std::errc()) { return {count, p, ec}; }
+            p = ptr;
+            ++count;
+        }
+        return {count, p, std::errc()};
+    }
+
+    /**
+     * @brief Parse up to max_count floating point (or signed) numbers separated by SPACES from s into out.
+     */
+    template <typename Num>
+    static inline ParseNumbersResult parse_floats(std::string_view s, Num* out, size_t max_count) {
+        static_assert(std::is_arithmetic_v<Num>);
+        const char* p = s.data();
+        const char* end = s.data() + s.size();
+        size_t count = 0;
+        while (count < max_count) {
+            p = skip_spaces(p, end);
+            if (p == end) { break; }
+            const auto [ptr, ec] = std::from_chars(p, end, out[count]);
+            if (ec != std::errc()) { return {count, p, ec}; }
+            p = ptr;
+            ++count;
+        }
+        return {count, p, std::errc()};
+    }
+
+}  // namespace cav
+
+#endif
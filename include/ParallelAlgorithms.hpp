@@ -0,0 +1,242 @@
+#ifndef CAV_PARALLELALGORITHMS_HPP
+#define CAV_PARALLELALGORITHMS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ParallelParse.hpp"
+#include "PtrIteratorWrap.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Data parallel algorithms over random access ranges accessed with r[i] and r.size() (std::vector, VectorView,
+ * ContainerJitMap and the other lazy views). The range is split in contiguous blocks (see parallel_blocks), each
+ * block is processed by one thread, partial results are combined in block order so that the result depends only on
+ * the number of blocks.
+ */
+
+namespace cav {
+
+    // Blocks are never smaller than this, below 2 blocks everything runs on the calling thread.
+    static constexpr size_t PARALLEL_MIN_GRAIN = 4096UL;
+
+    static inline unsigned default_nthreads() { return default_thread_pool().concurrency(); }
+
+    /**
+     * @brief Grain heuristic: a few blocks per thread to balance uneven work, none below PARALLEL_MIN_GRAIN elements.
+     */
+    static inline size_t parallel_blocks(size_t n, unsigned nthreads) {
+        const size_t by_grain = n / PARALLEL_MIN_GRAIN;
+        const size_t by_threads = static_cast<size_t>(std::max(nthreads, 1U)) * PARSE_CHUNKS_PER_THREAD;
+        return std::max<size_t>(1, std::min(by_grain, by_threads));
+    }
+
+    // Call f(b, first, last) for the nblocks contiguous blocks b covering [0, n).
+    template <typename Func>
+    void _parallel_for_indexed_blocks(size_t n, size_t nblocks, unsigned nthreads, Func&& f) {
+        if (nblocks <= 1) {
+            if (n > 0) { f(size_t(0), size_t(0), n); }
+            return;
+        }
+        parallel_for_chunks(nblocks, nthreads, [&](size_t b) { f(b, n * b / nblocks, n * (b + 1) / nblocks); });
+    }
+
+    /**
+     * @brief Call f(first, last) on nblocks contiguous blocks covering [0, n).
+     */
+    template <typename Func>
+    void parallel_for_blocks(size_t n, size_t nblocks, unsigned nthreads, Func&& f) {
+        _parallel_for_indexed_blocks(n, nblocks, nthreads, [&](size_t, size_t first, size_t last) { f(first, last); });
+    }
+
+    template <typename Func>
+    void parallel_for_blocks(size_t n, unsigned nthreads, Func&& f) {
+        parallel_for_blocks(n, parallel_blocks(n, nthreads), nthreads, std::forward<Func>(f));
+    }
+
+
+    ///////// RAW POINTER ACCESS /////////
+    template <typename It>
+    struct is_ptr_iterator_wrap : std::false_type { };
+
+    template <typename T>
+    struct is_ptr_iterator_wrap<PtrIteratorWrap<T>> : std::true_type { };
+
+    template <typename Range, typename = void>
+    struct has_data_member : std::false_type { };
+
+    template <typename Range>
+    struct has_data_member<Range, std::void_t<decltype(std::declval<Range&>().data())>> : std::true_type { };
+
+    /**
+     * @brief Pointer to the elements if r stores them contiguously without transforming them: ranges over raw
+     * pointers or PtrIteratorWrap (but not ContainerJitMap, whose iterators apply the op) and ranges with data().
+     * nullptr otherwise.
+     */
+    template <typename Range>
+    auto raw_data(Range& r) {
+        using It = std::decay_t<decltype(r.begin())>;
+        if constexpr (has_data_member<Range>::value) {
+            return r.data();
+        } else if constexpr (std::is_pointer_v<It>) {
+            return r.begin();
+        } else if constexpr (is_ptr_iterator_wrap<It>::value) {
+            return r.begin().base();
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename Range>
+    using range_value_t = std::decay_t<decltype(std::declval<const Range&>()[0])>;
+
+    // Sum with 8 independent accumulators, so that the compiler can keep them in one SIMD register.
+    template <typename T>
+    T _simd_sum(const T* p, size_t n, T init) {
+        T acc[8] = {};
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            for (int k = 0; k < 8; ++k) { acc[k] += p[i + k]; }
+        }
+        for (; i < n; ++i) { acc[0] += p[i]; }
+        for (int k = 0; k < 8; ++k) { init += acc[k]; }
+        return init;
+    }
+
+    template <typename T, typename Op>
+    T _block_reduce(const T* p, size_t first, size_t last, T init, Op& op) {
+        if constexpr (std::is_arithmetic_v<T> && (std::is_same_v<Op, std::plus<>> || std::is_same_v<Op, std::plus<T>>)) {
+            return _simd_sum(p + first, last - first, init);
+        } else {
+            for (size_t i = first; i < last; ++i) { init = op(init, p[i]); }
+            return init;
+        }
+    }
+
+
+    ///////// ALGORITHMS /////////
+    /**
+     * @brief Call f(r[i]) for each i, elements can be modified if r gives references.
+     */
+    template <typename Range, typename Func>
+    void parallel_for_each(Range&& r, Func f, unsigned nthreads = default_nthreads()) {
+        const auto p = raw_data(r);
+        parallel_for_blocks(static_cast<size_t>(r.size()), nthreads, [&](size_t first, size_t last) {
+            if constexpr (!std::is_null_pointer_v<decltype(p)>) {
+                for (size_t i = first; i < last; ++i) { f(p[i]); }
+            } else {
+                for (size_t i = first; i < last; ++i) { f(r[i]); }
+            }
+        });
+    }
+
+    /**
+     * @brief init op r[0] op r[1] op ... for the associative op. Every block starts from its own first element and
+     * init is combined once with the block results, so the result does not depend on nthreads (up to the rounding
+     * of floating point ops).
+     */
+    template <typename Range, typename T, typename Op = std::plus<>>
+    T parallel_reduce(const Range& r, T init, Op op = Op(), unsigned nthreads = default_nthreads()) {
+        const size_t n = static_cast<size_t>(r.size());
+        if (n == 0) { return init; }
+        const size_t nblocks = parallel_blocks(n, nthreads);
+        auto partial = std::vector<T>(nblocks, init);
+        const auto p = raw_data(r);
+
+        _parallel_for_indexed_blocks(n, nblocks, nthreads, [&](size_t b, size_t first, size_t last) {
+            T& acc = partial[b];
+            acc = static_cast<T>(r[first]);
+            if constexpr (!std::is_null_pointer_v<decltype(p)>) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(*p)>, T>) {
+                    acc = _block_reduce(p, first + 1, last, acc, op);
+                    return;
+                }
+            }
+            for (size_t i = first + 1; i < last; ++i) { acc = op(acc, r[i]); }
+        });
+
+        T result = init;
+        for (size_t b = 0; b < nblocks; ++b) { result = op(result, partial[b]); }
+        return result;
+    }
+
+    /**
+     * @brief Indices of the k smallest elements of r, sorted by value (ties by index).
+     */
+    template <typename Range>
+    std::vector<size_t> parallel_argmin_k(const Range& r, size_t k, unsigned nthreads = default_nthreads()) {
+        using T = range_value_t<Range>;
+        using Cand = std::pair<T, size_t>;
+
+        const size_t n = static_cast<size_t>(r.size());
+        k = std::min(k, n);
+        const size_t nblocks = parallel_blocks(n, nthreads);
+        auto candidates = std::vector<std::vector<Cand>>(nblocks);
+
+        // Each block keeps its best k in a max-heap, an element enters only if it beats the worst kept one.
+        _parallel_for_indexed_blocks(n, nblocks, nthreads, [&](size_t b, size_t first, size_t last) {
+            auto& heap = candidates[b];
+            heap.reserve(k);
+            for (size_t i = first; i < last && k > 0; ++i) {
+                if (heap.size() < k) {
+                    heap.emplace_back(r[i], i);
+                    std::push_heap(heap.begin(), heap.end());
+                } else if (r[i] < heap.front().first) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = Cand(r[i], i);
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        });
+
+        auto merged = std::move(candidates[0]);
+        for (size_t b = 1; b < nblocks; ++b) { merged.insert(merged.end(), candidates[b].begin(), candidates[b].end()); }
+        std::partial_sort(merged.begin(), merged.begin() + k, merged.end());
+
+        auto result = std::vector<size_t>(k);
+        for (size_t i = 0; i < k; ++i) { result[i] = merged[i].second; }
+        return result;
+    }
+
+    /**
+     * @brief out[i] = r[0] op r[1] op ... op r[i], out can alias r. Two passes: block totals, then each block is
+     * scanned again starting from the combination of the totals of the previous blocks.
+     *
+     * @return out + r.size()
+     */
+    template <typename Range, typename OutIt, typename Op = std::plus<>>
+    OutIt parallel_inclusive_scan(const Range& r, OutIt out, Op op = Op(), unsigned nthreads = default_nthreads()) {
+        using T = range_value_t<Range>;
+
+        const size_t n = static_cast<size_t>(r.size());
+        if (n == 0) { return out; }
+        const size_t nblocks = parallel_blocks(n, nthreads);
+
+        auto totals = std::vector<T>(nblocks);
+        if (nblocks > 1) {
+            _parallel_for_indexed_blocks(n, nblocks, nthreads, [&](size_t b, size_t first, size_t last) {
+                T acc = r[first];
+                for (size_t i = first + 1; i < last; ++i) { acc = op(acc, r[i]); }
+                totals[b] = acc;
+            });
+            for (size_t b = 1; b < nblocks; ++b) { totals[b] = op(totals[b - 1], totals[b]); }
+        }
+
+        _parallel_for_indexed_blocks(n, nblocks, nthreads, [&](size_t b, size_t first, size_t last) {
+            T acc = b == 0 ? r[first] : op(totals[b - 1], r[first]);
+            out[first] = acc;
+            for (size_t i = first + 1; i < last; ++i) {
+                acc = op(acc, r[i]);
+                out[i] = acc;
+            }
+        });
+        return out + n;
+    }
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CAV_PARALLELPARSE_HPP
+#define CAV_PARALLELPARSE_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace cav {
+
+    // Chunks per thread, more chunks balance better lines of different length.
+    static constexpr size_t PARSE_CHUNKS_PER_THREAD = 4UL;
+
+    static inline bool is_blank_line(std::string_view line) {
+        return std::all_of(line.begin(), line.end(), [](char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; });
+    }
+
+    /**
+     * @brief Prefix of text containing its first nlines non-blank lines (blank lines are not counted).
+     * If text has fewer lines, the whole text is returned.
+     */
+    static inline std::string_view take_lines(std::string_view text, size_t nlines) {
+        size_t pos = 0;
+        while (nlines > 0 && pos < text.size()) {
+            const void* nl = std::memchr(text.data() + pos, '\n', text.size() - pos);
+            const size_t next = nl != nullptr ? static_cast<const char*>(nl) - text.data() + 1 : text.size();
+            if (!is_blank_line(text.substr(pos, next - pos))) { --nlines; }
+            pos = next;
+        }
+        return text.substr(0, pos);
+    }
+
+    /**
+     * @brief Split text in at most nchunks pieces of similar size, cutting only after a '\n'.
+     */
+    static inline std::vector<std::string_view> split_at_newlines(std::string_view text, size_t nchunks) {
+        std::vector<std::string_view> chunks;
+        const size_t target = std::max<size_t>(1, text.size() / std::max<size_t>(nchunks, 1));
+
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = std::min(begin + target, text.size());
+            if (end < text.size()) {
+                const void* nl = std::memchr(text.data() + end, '\n', text.size() - end);
+                end = nl != nullptr ? static_cast<const char*>(nl) - text.data() + 1 : text.size();
+            }
+            chunks.emplace_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return chunks;
+    }
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * Matrix-vector kernels for set covering matrices with unit coefficients, stored as in BasicInstanceData: column j
+ * covers the rows matval[matbeg[j]..matbeg[j+1]). Since every coefficient is 1, the products are sums of gathered
+ * entries and no values array is read.
+ *
+ * - csc_reduced_costs: out_j = c_j - sum_{i in col j} u_i     (Lagrangian reduced costs)
+ * - csr_row_coverage:  out_i = sum_{j in row i} x_j          (row coverage, through the CSR transpose)
+ * - csc_to_csr:        CSR transpose, parallel counting sort (columns of each row stay sorted)
+ *
+ * Column and row blocks run on the shared thread pool. The inner sums use AVX2 gathers on long columns/rows (e.g.
+ * the rows of the CSR, that have thousands of entries on rail instances), where the summation order differs from a
+ * plain loop in the last bits; short columns are faster with scalar loads.
+ */
+
+#ifndef CAV_SCPKERNELS_HPP
+#define CAV_SCPKERNELS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "ParallelAlgorithms.hpp"
+
+namespace cav {
+
+    ///////// GATHER SUMS /////////
+    // Sum of v[idx[0..n)].
+    template <typename T>
+    static inline T gather_sum(const T* __restrict__ v, const int* __restrict__ idx, size_t n) {
+        T s = T();
+        for (size_t k = 0; k < n; ++k) { s += v[idx[k]]; }
+        return s;
+    }
+
+#if defined(__AVX2__)
+    // Below this many entries the scalar loop is faster than the gathers.
+    static constexpr size_t GATHER_MIN_LEN = 16;
+
+    static inline double gather_sum(const double* v, const int* idx, size_t n) {
+        if (n < GATHER_MIN_LEN) { return gather_sum<double>(v, idx, n); }
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256d acc = _mm256_setzero_pd();
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+            const __m128i vidx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + k));
+            acc = _mm256_add_pd(acc, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), v, vidx, all, 8));
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        double s = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        for (; k < n; ++k) { s += v[idx[k]]; }
+        return s;
+    }
+
+    static inline float gather_sum(const float* v, const int* idx, size_t n) {
+        if (n < GATHER_MIN_LEN) { return gather_sum<float>(v, idx, n); }
+        const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        __m256 acc = _mm256_setzero_ps();
+        size_t k = 0;
+        for (; k + 8 <= n; k += 8) {
+            const __m256i vidx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+            acc = _mm256_add_ps(acc, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), v, vidx, all, 4));
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        float s = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+        for (; k < n; ++k) { s += v[idx[k]]; }
+        return s;
+    }
+#endif
+
+
+    ///////// KERNELS /////////
+    /**
+     * @brief out[j] = costs[j] - sum of u over the rows of column j, for j in [0, ncols). out can alias costs.
+     */
+    template <typename T>
+    void csc_reduced_costs(size_t ncols, const int* matbeg, const int* matval, const T* costs, const T* u, T* out,
+                           unsigned nthreads = default_nthreads()) {
+        parallel_for_blocks(ncols, nthreads, [&](size_t first, size_t last) {
+            for (size_t j = first; j < last; ++j) { out[j] = costs[j] - gather_sum(u, matval + matbeg[j], static_cast<size_t>(matbeg[j + 1] - matbeg[j])); }
+        });
+    }
+
+    /**
+     * @brief out[i] = sum of x over the columns covering row i, for i in [0, nrows), on the CSR form.
+     */
+    template <typename T>
+    void csr_row_coverage(size_t nrows, const int* rowbeg, const int* rowval, const T* x, T* out, unsigned nthreads = default_nthreads()) {
+        parallel_for_blocks(nrows, nthreads, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) { out[i] = gather_sum(x, rowval + rowbeg[i], static_cast<size_t>(rowbeg[i + 1] - rowbeg[i])); }
+        });
+    }
+
+    /**
+     * @brief Row-major view of a binary matrix: row i is covered by the columns rowval[rowbeg[i]..rowbeg[i+1]), sorted.
+     */
+    struct BinaryCsr {
+        int nrows{};
+        std::vector<int> rowbeg;
+        std::vector<int> rowval;
+    };
+
+    /**
+     * @brief CSR transpose of the CSC matrix (matbeg, matval) with nrows rows. Every column block counts its rows,
+     * the per (block, row) counts are turned into write offsets, then the blocks scatter their column indices in
+     * parallel. Same result of the sequential counting sort.
+     */
+    static inline BinaryCsr csc_to_csr(size_t nrows, size_t ncols, const int* matbeg, const int* matval, unsigned nthreads = default_nthreads()) {
+        const size_t nnz = static_cast<size_t>(matbeg[ncols]);
+        const size_t nblocks = parallel_blocks(nnz, nthreads);
+        auto block_col = [&](size_t b) { return ncols * b / nblocks; };
+
+        // counts[b * nrows + i]: nonzeros of row i in column block b, then the write offset of that block
+        auto counts = std::vector<int>(nblocks * nrows, 0);
+        parallel_for_chunks(nblocks, nthreads, [&](size_t b) {
+            int* cnt = counts.data() + b * nrows;
+            for (int k = matbeg[block_col(b)]; k < matbeg[block_col(b + 1)]; ++k) { ++cnt[matval[k]]; }
+        });
+
+        auto csr = BinaryCsr();
+        csr.nrows = static_cast<int>(nrows);
+        csr.rowbeg.resize(nrows + 1);
+        csr.rowval.resize(nnz);
+
+        for (size_t i = 0; i < nrows; ++i) {
+            int offset = csr.rowbeg[i];
+            for (size_t b = 0; b < nblocks; ++b) {
+                const int c = counts[b * nrows + i];
+                counts[b * nrows + i] = offset;
+                offset += c;
+            }
+            csr.rowbeg[i + 1] = offset;
+        }
+
+        parallel_for_chunks(nblocks, nthreads, [&](size_t b) {
+            int* pos = counts.data() + b * nrows;
+            for (size_t j = block_col(b); j < block_col(b + 1); ++j) {
+                for (int k = matbeg[j]; k < matbeg[j + 1]; ++k) { csr.rowval[pos[matval[k]]++] = static_cast<int>(j); }
+            }
+        });
+        return csr;
+    }
+
+
+    ///////// INSTANCE OVERLOADS /////////
+    // Inst is a BasicInstanceData (or anything with nrows, costs, matbeg and matval).
+    template <typename Inst>
+    BinaryCsr csc_to_csr(const Inst& inst, unsigned nthreads = default_nthreads()) {
+        return csc_to_csr(static_cast<size_t>(inst.nrows), inst.costs.size(), inst.matbeg.data(), inst.matval.data(), nthreads);
+    }
+
+    template <typename Inst>
+    void csc_reduced_costs(const Inst& inst, const double* u, double* out, unsigned nthreads = default_nthreads()) {
+        csc_reduced_costs(inst.costs.size(), inst.matbeg.data(), inst.matval.data(), inst.costs.data(), u, out, nthreads);
+    }
+
+    template <typename T>
+    void csr_row_coverage(const BinaryCsr& csr, const T* x, T* out, unsigned nthreads = default_nthreads()) {
+        csr_row_coverage(static_cast<size_t>(csr.nrows), csr.rowbeg.data(), csr.rowval.data(), x, out, nthreads);
+    }
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * Lagrangian lower bounds for set covering, with the subgradient scheme of Beasley and of Caprara, Fischetti and Toth
+ * ("A heuristic method for the set covering problem", Operations Research 1999).
+ *
+ * Relaxing the covering rows with multipliers u >= 0 gives L(u) = sum_i u_i + sum_j min(0, c_j(u)), where
+ * c_j(u) = c_j - sum_{i in col j} u_i is the reduced cost of column j, and every L(u) is a valid lower bound.
+ *
+ * - Core problem: the subgradient iterations only see a core of columns, the 5 best (by reduced cost) of each row
+ *   plus the 5 * nrows globally best. Every pricing period the reduced costs of all the columns are recomputed (this is
+ *   also the only point where a valid bound is certified), the core is rebuilt and the period adapted to how far the
+ *   core bound was from the full one.
+ * - Incremental reduced costs: after a step only the rows whose multiplier moved update the core columns they touch.
+ * - Step size lambda * (UB - L) / ||s||^2, lambda halved/increased every period iterations depending on the spread of
+ *   the last bounds. UB comes from a greedy on the core, rerun at every pricing.
+ * - Early termination: integral costs with ceil(LB) >= UB (the greedy solution is optimal), lambda below min_lambda,
+ *   stagnation of the bound, iteration and time limits.
+ */
+
+#ifndef CAV_SCPLAGRANGIAN_HPP
+#define CAV_SCPLAGRANGIAN_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ContainerJitMap.hpp"
+#include "IndexedHeap.hpp"
+#include "ParallelAlgorithms.hpp"
+#include "ScpKernels.hpp"
+
+namespace cav {
+
+    struct LagrangianOptions {
+        size_t max_iters = 100000;
+        double time_limit = 10.0;        // seconds
+        double lambda = 0.1;             // initial step size factor
+        double min_lambda = 1e-4;        // stop below this
+        size_t lambda_period = 20;       // lambda is adjusted every lambda_period iterations
+        size_t stagnation_iters = 300;   // stop if the core bound improves less than stagnation_tol in this many iterations
+        double stagnation_tol = 1e-3;    // relative
+        size_t core_per_row = 5;         // best columns of each row in the core
+        size_t core_global_factor = 5;   // plus core_global_factor * nrows globally best columns
+        size_t first_pricing_period = 10;
+        double upper_bound = std::numeric_limits<double>::infinity();  // known UB, the greedy one is used if better
+        unsigned nthreads = default_nthreads();
+    };
+
+    struct LagrangianResult {
+        double lower_bound = -std::numeric_limits<double>::infinity();
+        double upper_bound = std::numeric_limits<double>::infinity();
+        std::vector<double> multipliers;  // of the best lower bound
+        std::vector<int> solution;        // columns of the best greedy solution
+        double solution_cost = std::numeric_limits<double>::infinity();
+        size_t iterations = 0;
+        size_t pricings = 0;
+        bool optimal = false;  // the lower bound proves that solution is optimal
+    };
+
+    /**
+     * @brief Subgradient optimization of the Lagrangian dual of the set covering instance inst (a BasicInstanceData).
+     *
+     * @tparam Inst
+     */
+    template <typename Inst>
+    class ScpLagrangian {
+        using clock = std::chrono::steady_clock;
+
+    public:
+        explicit ScpLagrangian(const Inst& _inst, unsigned nthreads = default_nthreads())
+            : inst(_inst), nrows(static_cast<size_t>(_inst.nrows)), ncols(_inst.costs.size()), rows(csc_to_csr(_inst, nthreads)) {
+            for (size_t i = 0; i < nrows; ++i) {
+                if (rows.rowbeg[i] == rows.rowbeg[i + 1]) { throw std::runtime_error("Error: row " + std::to_string(i) + " is not covered by any column."); }
+            }
+            integral_costs = std::all_of(inst.costs.begin(), inst.costs.end(), [](double c) { return c == std::floor(c); });
+        }
+
+        // Beasley/CFT initial multipliers: u_i = min over the columns j covering i of c_j / |col j|.
+        std::vector<double> initial_multipliers() const {
+            auto u = std::vector<double>(nrows);
+            for (size_t i = 0; i < nrows; ++i) {
+                double best = std::numeric_limits<double>::infinity();
+                for (int k = rows.rowbeg[i]; k < rows.rowbeg[i + 1]; ++k) {
+                    const int j = rows.rowval[k];
+                    best = std::min(best, inst.costs[j] / (inst.matbeg[j + 1] - inst.matbeg[j]));
+                }
+                u[i] = best;
+            }
+            return u;
+        }
+
+        LagrangianResult solve(const LagrangianOptions& opts = LagrangianOptions()) { return solve(initial_multipliers(), opts); }
+
+        LagrangianResult solve(std::vector<double> u, const LagrangianOptions& opts) {
+            const auto start = clock::now();
+            auto res = LagrangianResult();
+            res.upper_bound = opts.upper_bound;
+            res.multipliers = u;
+
+            double lambda = opts.lambda;
+            size_t pricing_period = opts.first_pricing_period;
+            size_t next_pricing = 0;
+            double lb_core = 0.0, last_lb_core = 0.0;
+
+            // window of the last lambda_period core bounds, and the best one for the stagnation test
+            double period_min = std::numeric_limits<double>::infinity(), period_max = -period_min;
+            double stagnation_ref = 0.0;
+            size_t stagnation_start = 0;
+
+            auto x = std::vector<double>(), cover = std::vector<double>(nrows), s = std::vector<double>(nrows);
+
+            for (size_t iter = 0;; ++iter) {
+                const bool pricing = iter == next_pricing;
+                if (pricing) {
+                    const double lb_full = _price(u, opts);
+                    ++res.pricings;
+                    if (lb_full > res.lower_bound) {
+                        res.lower_bound = lb_full;
+                        res.multipliers = u;
+                    }
+                    _greedy(res);
+                    if (_proven(res)) { break; }
+
+                    // CFT: the closer the core bound was to the full one, the longer the next period
+                    if (iter > 0) {
+                        const double gap = (last_lb_core - lb_full) / std::max(std::abs(lb_full), 1.0);
+                        if (gap <= 1e-6) {
+                            pricing_period = std::min<size_t>(pricing_period * 10, 1000);
+                        } else if (gap <= 0.02) {
+                            pricing_period = std::min<size_t>(pricing_period * 5, 1000);
+                        } else if (gap <= 0.2) {
+                            pricing_period = std::min<size_t>(pricing_period * 2, 1000);
+                        } else {
+                            pricing_period = opts.first_pricing_period;
+                        }
+                    }
+                    next_pricing = iter + pricing_period;
+                    x.resize(core_cols.size());
+                }
+
+                if (iter >= opts.max_iters || lambda < opts.min_lambda || std::chrono::duration<double>(clock::now() - start).count() > opts.time_limit) { break; }
+
+                // core bound and subgradient s_i = 1 - (columns with negative reduced cost covering i)
+                lb_core = std::accumulate(u.begin(), u.end(), 0.0);
+                for (size_t k = 0; k < core_cols.size(); ++k) {
+                    x[k] = core_rc[k] < 0.0 ? 1.0 : 0.0;
+                    lb_core += std::min(core_rc[k], 0.0);
+                }
+                csr_row_coverage(core_rows, x.data(), cover.data(), 1);
+                last_lb_core = lb_core;
+
+                double norm = 0.0;
+                for (size_t i = 0; i < nrows; ++i) {
+                    s[i] = 1.0 - cover[i];
+                    if (u[i] == 0.0 && s[i] < 0.0) { s[i] = 0.0; }  // projected direction
+                    norm += s[i] * s[i];
+                }
+                if (norm == 0.0) {  // x covers the core exactly: u is optimal for the core, check the other columns
+                    if (pricing) { break; }
+                    next_pricing = iter + 1;
+                    continue;
+                }
+
+                // lambda update on the spread of the last bounds
+                period_min = std::min(period_min, lb_core);
+                period_max = std::max(period_max, lb_core);
+                if ((iter + 1) % opts.lambda_period == 0) {
+                    const double spread = (period_max - period_min) / std::max(std::abs(period_max), 1.0);
+                    if (spread > 0.01) {
+                        lambda /= 2.0;
+                    } else if (spread < 0.001) {
+                        lambda = std::min(lambda * 1.5, 10.0);
+                    }
+                    period_min = std::numeric_limits<double>::infinity();
+                    period_max = -period_min;
+                }
+
+                if (res.iterations == 0 || lb_core > stagnation_ref + opts.stagnation_tol * std::abs(stagnation_ref) + 1e-9) {
+                    stagnation_ref = lb_core;
+                    stagnation_start = iter;
+                } else if (iter - stagnation_start >= opts.stagnation_iters) {
+                    break;
+                }
+
+                // step, only the rows whose multiplier moved update their core columns
+                const double target = std::isfinite(res.upper_bound) ? res.upper_bound : 1.05 * std::abs(lb_core) + 1.0;
+                const double step = lambda * std::max(target - lb_core, 1e-6 * std::abs(target)) / norm;
+                for (size_t i = 0; i < nrows; ++i) {
+                    if (s[i] == 0.0) { continue; }
+                    const double ui = std::max(0.0, u[i] + step * s[i]);
+                    const double delta = ui - u[i];
+                    if (delta == 0.0) { continue; }
+                    u[i] = ui;
+                    for (int k = core_rows.rowbeg[i]; k < core_rows.rowbeg[i + 1]; ++k) { core_rc[core_rows.rowval[k]] -= delta; }
+                }
+                res.iterations = iter + 1;
+            }
+
+            // certify the last multipliers too
+            if (!res.optimal) {
+                const double lb_full = _price(u, opts);
+                ++res.pricings;
+                if (lb_full > res.lower_bound) {
+                    res.lower_bound = lb_full;
+                    res.multipliers = u;
+                }
+                _proven(res);
+            }
+            return res;
+        }
+
+    private:
+        /**
+         * @brief Reduced costs of all the columns for u, rebuild the core on them.
+         *
+         * @return L(u) on the whole instance
+         */
+        double _price(const std::vector<double>& u, const LagrangianOptions& opts) {
+            full_rc.resize(ncols);
+            csc_reduced_costs(inst, u.data(), full_rc.data(), opts.nthreads);
+            const double lb = std::accumulate(u.begin(), u.end(), 0.0) +
+                              parallel_reduce(make_lazy(full_rc).map([](double r) { return std::min(r, 0.0); }), 0.0, std::plus<>(), opts.nthreads);
+
+            // core: best columns of each row, plus the globally best ones
+            in_core.assign(ncols, 0);
+            auto best = std::vector<int>();
+            for (size_t i = 0; i < nrows; ++i) {
+                best.clear();
+                for (int k = rows.rowbeg[i]; k < rows.rowbeg[i + 1]; ++k) {
+                    const int j = rows.rowval[k];
+                    if (best.size() < opts.core_per_row || full_rc[j] < full_rc[best.back()]) {
+                        if (best.size() == opts.core_per_row) { best.pop_back(); }
+                        best.insert(std::upper_bound(best.begin(), best.end(), j, [&](int a, int b) { return full_rc[a] < full_rc[b]; }), j);
+                    }
+                }
+                for (int j : best) { in_core[j] = 1; }
+            }
+            for (size_t j : parallel_argmin_k(full_rc, opts.core_global_factor * nrows, opts.nthreads)) { in_core[j] = 1; }
+
+            core_cols.clear();
+            core_matbeg.assign(1, 0);
+            core_matval.clear();
+            core_rc.clear();
+            for (size_t j = 0; j < ncols; ++j) {
+                if (!in_core[j]) { continue; }
+                core_cols.push_back(static_cast<int>(j));
+                core_matval.insert(core_matval.end(), inst.matval.begin() + inst.matbeg[j], inst.matval.begin() + inst.matbeg[j + 1]);
+                core_matbeg.push_back(static_cast<int>(core_matval.size()));
+                core_rc.push_back(full_rc[j]);
+            }
+            core_rows = csc_to_csr(nrows, core_cols.size(), core_matbeg.data(), core_matval.data(), opts.nthreads);
+            return lb;
+        }
+
+        /**
+         * @brief Greedy cover of the core with the CFT scores (reduced cost / newly covered rows if positive, times
+         * them otherwise), then redundant columns are removed from the most expensive. Updates res if better.
+         */
+        void _greedy(LagrangianResult& res) {
+            const size_t n = core_cols.size();
+            auto mu = std::vector<int>(n);
+            auto covered = std::vector<int>(nrows, 0);
+            auto score = [&](size_t k) { return core_rc[k] > 0.0 ? core_rc[k] / mu[k] : core_rc[k] * mu[k]; };
+
+            auto heap = IndexedHeap<uint32_t, double>(n);
+            for (size_t k = 0; k < n; ++k) {
+                mu[k] = core_matbeg[k + 1] - core_matbeg[k];
+                heap.push(static_cast<uint32_t>(k), score(k));
+            }
+
+            // scores only grow while rows get covered, so a stale top is recomputed and pushed back
+            auto sol = std::vector<int>();
+            size_t uncovered = nrows;
+            while (uncovered > 0 && !heap.empty()) {
+                const auto top = heap.pop();
+                const size_t k = top.id;
+                mu[k] = 0;
+                for (int p = core_matbeg[k]; p < core_matbeg[k + 1]; ++p) { mu[k] += covered[core_matval[p]] == 0; }
+                if (mu[k] == 0) { continue; }
+                if (score(k) > top.prio) {
+                    heap.push(static_cast<uint32_t>(k), score(k));
+                    continue;
+                }
+                sol.push_back(static_cast<int>(k));
+                for (int p = core_matbeg[k]; p < core_matbeg[k + 1]; ++p) { uncovered -= covered[core_matval[p]]++ == 0; }
+            }
+            if (uncovered > 0) { return; }
+
+            std::sort(sol.begin(), sol.end(), [&](int a, int b) { return inst.costs[core_cols[a]] > inst.costs[core_cols[b]]; });
+            double cost = 0.0;
+            auto kept = std::vector<int>();
+            for (int k : sol) {
+                bool redundant = true;
+                for (int p = core_matbeg[k]; p < core_matbeg[k + 1] && redundant; ++p) { redundant = covered[core_matval[p]] > 1; }
+                if (redundant) {
+                    for (int p = core_matbeg[k]; p < core_matbeg[k + 1]; ++p) { --covered[core_matval[p]]; }
+                } else {
+                    kept.push_back(core_cols[k]);
+                    cost += inst.costs[core_cols[k]];
+                }
+            }
+            res.upper_bound = std::min(res.upper_bound, cost);
+            if (cost < res.solution_cost) {
+                std::sort(kept.begin(), kept.end());
+                res.solution = std::move(kept);
+                res.solution_cost = cost;
+            }
+        }
+
+        bool _proven(LagrangianResult& res) const {
+            const double lb = integral_costs ? std::ceil(res.lower_bound - 1e-6) : res.lower_bound;
+            res.optimal = lb >= res.solution_cost - 1e-9;
+            return res.optimal;
+        }
+
+        const Inst& inst;
+        size_t nrows;
+        size_t ncols;
+        BinaryCsr rows;  // of the whole instance
+        bool integral_costs;
+
+        std::vector<double> full_rc;
+        std::vector<char> in_core;
+        std::vector<int> core_cols;  // core column -> instance column
+        std::vector<int> core_matbeg;
+        std::vector<int> core_matval;
+        std::vector<double> core_rc;
+        BinaryCsr core_rows;  // core columns of each row
+    };
+
+}  // namespace cav
+
+#endif
@@ -2,33 +2,209 @@
 #define CAV_STRINGUTILS_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #define SPACES " \t\n\r\f\v"
 
 namespace cav {
 
+    /**
+     * @brief 256-entry membership table: one load per character instead of a scan of the delimiter list.
+     */
+    struct CharSet {
+        constexpr explicit CharSet(const char* chars) : table() {
+            for (; *chars != '\0'; ++chars) { table[static_cast<unsigned char>(*chars)] = true; }
+        }
+
+        constexpr explicit CharSet(char c) : table() { table[static_cast<unsigned char>(c)] = true; }
+
+        constexpr bool operator()(char c) const { return table[static_cast<unsigned char>(c)]; }
+
+        bool table[256];
+    };
+
+    inline constexpr CharSet SPACES_SET = CharSet(SPACES);
+
+
+    ///////// SPACES KERNELS /////////
+    // SPACES are ' ' and the contiguous range '\t'..'\r' (9..13), so two compares per byte are enough.
+
+#if defined(__AVX2__)
+    static inline uint32_t _spaces_mask32(const char* p) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i blank = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        const __m256i ctrl = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(8)), _mm256_cmpgt_epi8(_mm256_set1_epi8(14), v));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(blank, ctrl)));
+    }
+#elif defined(__SSE2__)
+    static inline uint32_t _spaces_mask16(const char* p) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i blank = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+        const __m128i ctrl = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(8)), _mm_cmpgt_epi8(_mm_set1_epi8(14), v));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(blank, ctrl)));
+    }
+#endif
+
+    /**
+     * @brief Bit i is set if p[i] is one of the SPACES, for the 64 bytes starting at p (that must be readable).
+     */
+    static inline uint64_t spaces_mask64(const char* p) {
+#if defined(__AVX2__)
+        return static_cast<uint64_t>(_spaces_mask32(p)) | (static_cast<uint64_t>(_spaces_mask32(p + 32)) << 32);
+#elif defined(__SSE2__)
+        return static_cast<uint64_t>(_spaces_mask16(p)) | (static_cast<uint64_t>(_spaces_mask16(p + 16)) << 16) |
+               (static_cast<uint64_t>(_spaces_mask16(p + 32)) << 32) | (static_cast<uint64_t>(_spaces_mask16(p + 48)) << 48);
+#else
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; ++i) { mask |= static_cast<uint64_t>(SPACES_SET(p[i])) << i; }
+        return mask;
+#endif
+    }
+
+    /**
+     * @brief Token boundaries in the 64 bytes starting at p: bit i of starts is set if a token (maximal run of non
+     * SPACES) begins at p[i], bit i of ends if one ends right before p[i]. prev_space tells whether p[-1] is a space
+     * (true at the beginning of the buffer).
+     *
+     * @return the spaces mask of the block
+     */
+    static inline uint64_t token_boundaries64(const char* p, bool prev_space, uint64_t& starts, uint64_t& ends) {
+        const uint64_t sp = spaces_mask64(p);
+        const uint64_t prev = (sp << 1) | static_cast<uint64_t>(prev_space);
+        starts = ~sp & prev;
+        ends = sp & ~prev;
+        return sp;
+    }
+
+    /**
+     * @brief Views on the tokens of s separated by runs of SPACES (no empty tokens), appended to out.
+     */
+    static inline void split_views(std::string_view s, std::vector<std::string_view>& out) {
+        const char* p = s.data();
+        const size_t n = s.size();
+        bool prev_space = true;
+        size_t tok_begin = 0;
+
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64) {
+            uint64_t starts, ends;
+            const uint64_t sp = token_boundaries64(p + i, prev_space, starts, ends);
+            for (uint64_t events = starts | ends; events != 0; events &= events - 1) {
+                const int b = __builtin_ctzll(events);
+                if ((starts >> b) & 1U) {
+                    tok_begin = i + b;
+                } else {
+                    out.emplace_back(p + tok_begin, i + b - tok_begin);
+                }
+            }
+            prev_space = (sp >> 63) != 0;
+        }
+
+        for (; i < n; ++i) {
+            const bool space = SPACES_SET(p[i]);
+            if (prev_space && !space) { tok_begin = i; }
+            if (!prev_space && space) { out.emplace_back(p + tok_begin, i - tok_begin); }
+            prev_space = space;
+        }
+        if (!prev_space) { out.emplace_back(p + tok_begin, n - tok_begin); }
+    }
+
+    static inline std::vector<std::string_view> split_views(std::string_view s) {
+        std::vector<std::string_view> out;
+        split_views(s, out);
+        return out;
+    }
+
+    // Same, for a generic set of delimiters (table lookup, no SIMD).
+    static inline void split_views(std::string_view s, const CharSet& delim, std::vector<std::string_view>& out) {
+        size_t i = 0;
+        while (i < s.size()) {
+            while (i < s.size() && delim(s[i])) { ++i; }
+            const size_t tok_begin = i;
+            while (i < s.size() && !delim(s[i])) { ++i; }
+            if (i > tok_begin) { out.emplace_back(s.data() + tok_begin, i - tok_begin); }
+        }
+    }
+
+    // Replace each run of SPACES with a single ' '.
+    static inline void collapse_spaces(std::string& s) {
+        char* w = s.data();
+        const char* r = s.data();
+        const size_t n = s.size();
+        bool prev_space = false;
+
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64) {
+            const uint64_t sp = spaces_mask64(r + i);
+            if (sp == 0) {  // the common case, a block without spaces
+                std::memmove(w, r + i, 64);
+                w += 64;
+                prev_space = false;
+                continue;
+            }
+            for (int b = 0; b < 64; ++b) {
+                const bool space = (sp >> b) & 1U;
+                if (!space) {
+                    *w++ = r[i + b];
+                } else if (!prev_space) {
+                    *w++ = ' ';
+                }
+                prev_space = space;
+            }
+        }
+        for (; i < n; ++i) {
+            const bool space = SPACES_SET(r[i]);
+            if (!space) {
+                *w++ = r[i];
+            } else if (!prev_space) {
+                *w++ = ' ';
+            }
+            prev_space = space;
+        }
+        s.resize(w - s.data());
+    }
+
+
+    ///////// TRIMMING /////////
     // Inplace with string
-    static inline void ltrim(std::string& s, const char* delim = SPACES) { s.erase(0, s.find_first_not_of(delim)); }
+    static inline void ltrim(std::string& s, const CharSet& delim = SPACES_SET) {
+        size_t i = 0;
+        while (i < s.size() && delim(s[i])) { ++i; }
+        s.erase(0, i);
+    }
 
-    static inline void rtrim(std::string& s, const char* delim = SPACES) { s.erase(s.find_last_not_of(delim) + 1); }
+    static inline void rtrim(std::string& s, const CharSet& delim = SPACES_SET) {
+        size_t i = s.size();
+        while (i > 0 && delim(s[i - 1])) { --i; }
+        s.erase(i);
+    }
 
-    static inline void trim(std::string& s, const char* delim = SPACES) {
-        ltrim(s, delim);
+    static inline void trim(std::string& s, const CharSet& delim = SPACES_SET) {
         rtrim(s, delim);
+        ltrim(s, delim);
     }
 
+    static inline void ltrim(std::string& s, const char* delim) { ltrim(s, CharSet(delim)); }
+    static inline void rtrim(std::string& s, const char* delim) { rtrim(s, CharSet(delim)); }
+    static inline void trim(std::string& s, const char* delim) { trim(s, CharSet(delim)); }
+
     // Remove multiple adjacent chars listed in delim, leaving only delim[0] as delimiter char
     static inline void remove_multiple_adj(std::string& s, const char* delim = SPACES) {
+        if (std::strcmp(delim, SPACES) == 0) { return collapse_spaces(s); }
 
-        const char* delim_end = delim;
-        while (*delim_end != '\0') ++delim_end;
-
+        const CharSet is_delim(delim);
         auto s_wit = s.begin();
         bool prev_is_delim = false;
-        for (char& c : s) {
-            if (std::find(delim, delim_end, c)) {
+        for (char c : s) {
+            if (is_delim(c)) {
                 if (!prev_is_delim) {
                     *s_wit = delim[0];
                     ++s_wit;
@@ -44,11 +220,23 @@ namespace cav {
     }
 
     // Return "new" object with string_view (which are only a proxy on the same memory)
-    static inline std::string_view ltrim(std::string_view s, const char* delim = SPACES) { return s.substr(s.find_first_not_of(delim)); }
+    static inline std::string_view ltrim(std::string_view s, const CharSet& delim = SPACES_SET) {
+        size_t i = 0;
+        while (i < s.size() && delim(s[i])) { ++i; }
+        return s.substr(i);
+    }
+
+    static inline std::string_view rtrim(std::string_view s, const CharSet& delim = SPACES_SET) {
+        size_t i = s.size();
+        while (i > 0 && delim(s[i - 1])) { --i; }
+        return s.substr(0, i);
+    }
 
-    static inline std::string_view rtrim(std::string_view s, const char* delim = SPACES) { return s.substr(s.find_last_not_of(delim) + 1); }
+    static inline std::string_view trim(std::string_view s, const CharSet& delim = SPACES_SET) { return rtrim(ltrim(s, delim), delim); }
 
-    static inline std::string_view trim(std::string_view s, const char* delim = SPACES) { return rtrim(ltrim(s, delim), delim); }
+    static inline std::string_view ltrim(std::string_view s, const char* delim) { return ltrim(s, CharSet(delim)); }
+    static inline std::string_view rtrim(std::string_view s, const char* delim) { return rtrim(s, CharSet(delim)); }
+    static inline std::string_view trim(std::string_view s, const char* delim) { return trim(s, CharSet(delim)); }
 
     static inline std::string remove_multiple_adj(std::string_view& s, const char* delim = SPACES) {
         std::string s_new(s);
@@ -58,4 +246,4 @@ namespace cav {
 
 }  // namespace cav
 
-#endif
\ No newline at end of file
+#endif
@@ -3,20 +3,33 @@
 
 #include <fmt/core.h>
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
-#include <fstream>
-#include <sstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-#include "StringUtils.hpp"
+#include "MappedFile.hpp"
+#include "ParallelParse.hpp"
+#include "TspLibLexer.hpp"
 
 struct customer {
     double x = 0.0;
     double y = 0.0;
 };
 
-struct TSPInstance {
+/**
+ * @brief TSPLIB instance with the complete edge list in concorde format. The arrays come from (rebinds of) Alloc, so
+ * a cav::ArenaAllocator can be used to free them with the arena.
+ * With nthreads > 1 the NODE_COORD_SECTION is split at line boundaries and parsed in parallel.
+ */
+template <typename Alloc = std::allocator<int>>
+struct BasicTSPInstance {
+    using CustAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<customer>;
+    using IntAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<int>;
 
     std::string filename;
 
@@ -25,53 +38,52 @@ struct TSPInstance {
     std::string type;
     std::string edge_type;
 
-    int dimension;
+    int dimension = 0;
     customer* customers = nullptr;
 
     int ecount;
     int* elist = nullptr;
     int* elength = nullptr;
 
-public:
-    explicit TSPInstance(std::string filename_) : filename(filename_) {
-        std::ifstream input_file(filename);
-
-        if (!input_file.is_open()) { throw std::string("Error opening file " + filename); }
-
-        std::string key;
-        std::string line;
-        while (std::getline(input_file, line)) {
-
-            std::istringstream line_stream(line);
-            std::getline(line_stream, key, ':');
-            trim(key, " \t\n\r\f\v");
+    CustAlloc cust_alloc;
+    IntAlloc int_alloc;
 
-            fmt::print(key + '\n');
+public:
+    explicit BasicTSPInstance(std::string filename_, const Alloc& allocator = Alloc(), unsigned nthreads = 1)
+        : filename(filename_), cust_alloc(allocator), int_alloc(allocator) {
+        const auto file = cav::MappedFile(filename);
+        auto lex = cav::TspLibLexer(file.view());
 
-            if (key.empty()) { continue; }
+        std::string_view key;
+        while (lex.next_key(key)) {
 
             if (key == "EOF") {
                 break;
             } else if (key == "NAME") {
-                line_stream >> name;
+                name = lex.line_value();
             } else if (key == "COMMENT") {
-                getline(line_stream, comment, '\n');
+                comment = lex.line_value();
             } else if (key == "TYPE") {
-                line_stream >> type;
+                type = lex.line_value();
             } else if (key == "DIMENSION") {
-                line_stream >> dimension;
-                customers = new customer[dimension];
+                dimension = lex.value<int>();
+                customers = std::allocator_traits<CustAlloc>::allocate(cust_alloc, dimension);
+                std::uninitialized_value_construct(customers, customers + dimension);
             } else if (key == "EDGE_WEIGHT_TYPE") {
-                line_stream >> edge_type;
+                edge_type = lex.line_value();
             } else if (key == "DISPLAY_DATA_TYPE") {
-                continue;
+                lex.skip_line();
+            } else if (key == "NODE_COORD_SECTION" && nthreads > 1) {
+                parse_coords_parallel(lex, nthreads);
             } else if (key == "NODE_COORD_SECTION") {
-                for (int i = 0, idx; i < dimension; ++i) {
-                    input_file >> idx;
-                    input_file >> customers[idx - 1].x >> customers[idx - 1].y;
+                for (int i = 0; i < dimension; ++i) {
+                    const int idx = lex.value<int>();
+                    if (idx < 1 || idx > dimension) { throw std::string("Node index out of range in " + filename); }
+                    customers[idx - 1].x = lex.value<double>();
+                    customers[idx - 1].y = lex.value<double>();
                 }
             } else {
-                throw std::string("Unexpected data in input file: " + key);
+                throw std::string("Unexpected data in input file: " + std::string(key));
             }
         }
 
@@ -84,8 +96,8 @@ public:
         fmt::print("-----------------------------------------------------------------------------------------------\n");
 
         ecount = (dimension * (dimension - 1)) / 2;
-        elist = new int[ecount * 2];
-        elength = new int[ecount];
+        elist = std::allocator_traits<IntAlloc>::allocate(int_alloc, ecount * 2);
+        elength = std::allocator_traits<IntAlloc>::allocate(int_alloc, ecount);
 
         int edge = 0;
         int edge_w = 0;
@@ -99,10 +111,46 @@ public:
         }
     }
 
-    ~TSPInstance() {
-        delete[] customers;
-        delete[] elist;
-        delete[] elength;
+    BasicTSPInstance(const BasicTSPInstance&) = delete;
+    BasicTSPInstance& operator=(const BasicTSPInstance&) = delete;
+
+    ~BasicTSPInstance() {
+        if (customers != nullptr) { std::allocator_traits<CustAlloc>::deallocate(cust_alloc, customers, dimension); }
+        if (elist != nullptr) { std::allocator_traits<IntAlloc>::deallocate(int_alloc, elist, ecount * 2); }
+        if (elength != nullptr) { std::allocator_traits<IntAlloc>::deallocate(int_alloc, elength, ecount); }
+    }
+
+    // Each chunk collects its (index, customer) records, then they are written in file order as the sequential loop.
+    void parse_coords_parallel(cav::TspLibLexer& lex, unsigned nthreads) {
+        const auto section = cav::take_lines(std::string_view(lex.position(), lex.input_end() - lex.position()), dimension);
+        const auto chunks = cav::split_at_newlines(section, nthreads * cav::PARSE_CHUNKS_PER_THREAD);
+
+        std::vector<std::vector<std::pair<int, customer>>> records(chunks.size());
+        std::atomic<bool> malformed{false};
+        cav::parallel_for_chunks(chunks.size(), nthreads, [&](size_t c) {
+            auto clex = cav::TspLibLexer(chunks[c]);
+            int idx;
+            customer cust;
+            while (!clex.at_end()) {
+                if (!clex.try_value(idx) || !clex.try_value(cust.x) || !clex.try_value(cust.y)) {
+                    malformed = true;  // no throwing from the workers
+                    return;
+                }
+                records[c].emplace_back(idx, cust);
+            }
+        });
+        if (malformed) { throw std::string("Malformed NODE_COORD_SECTION in " + filename); }
+
+        int nrecords = 0;
+        for (const auto& chunk_records : records) {
+            for (const auto& [idx, cust] : chunk_records) {
+                if (idx < 1 || idx > dimension) { throw std::string("Node index out of range in " + filename); }
+                customers[idx - 1] = cust;
+            }
+            nrecords += chunk_records.size();
+        }
+        if (nrecords != dimension) { throw std::string("Wrong number of nodes in NODE_COORD_SECTION of " + filename); }
+        lex.seek(section.data() + section.size());
     }
 
     // classic euclidean distance
@@ -119,4 +167,6 @@ public:
     }
 };
 
+using TSPInstance = BasicTSPInstance<>;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,457 @@
+/**
+ * Work-stealing thread pool.
+ *
+ * Every worker owns a Chase-Lev deque: it pushes and pops tasks at the bottom (LIFO, cache friendly for nested
+ * parallelism) while idle workers steal from the top. Tasks submitted by threads that are not workers go to a shared
+ * injection queue. A TaskGroup counts its pending tasks, wait() executes tasks (of any group) while the count is
+ * positive, so waiting inside a task never blocks a worker and nested parallel loops do not deadlock.
+ *
+ * default_thread_pool() is the pool shared by all the parallel algorithms of the library: hardware_concurrency() - 1
+ * workers plus the thread that waits, so they never oversubscribe the machine.
+ *
+ * NOTE: memory orders follow Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013), with
+ * the standalone fences replaced by seq_cst/release operations on top and bottom.
+ */
+
+#ifndef CAV_THREADPOOL_HPP
+#define CAV_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "NonCopyable.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Chase-Lev deque of pointers: push/pop only from the owner thread, steal from any thread.
+     * The ring grows when full, replaced rings are kept until destruction since a thief may still read them.
+     *
+     * @tparam T pointed type
+     */
+    template <typename T>
+    class WorkStealingDeque : private NonCopyable<WorkStealingDeque<T>> {
+        struct Ring {
+            explicit Ring(int64_t _capacity) : capacity(_capacity), buf(new std::atomic<T*>[_capacity]) { }
+
+            T* get(int64_t i) const { return buf[i & (capacity - 1)].load(std::memory_order_relaxed); }
+            void put(int64_t i, T* x) { buf[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+
+            int64_t capacity;
+            std::unique_ptr<std::atomic<T*>[]> buf;
+        };
+
+    public:
+        explicit WorkStealingDeque(int64_t capacity = 256) {
+            rings.emplace_back(new Ring(capacity));
+            ring.store(rings.back().get(), std::memory_order_relaxed);
+        }
+
+        void push(T* x) {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_acquire);
+            Ring* r = ring.load(std::memory_order_relaxed);
+            if (b - t > r->capacity - 1) { r = _grow(r, t, b); }
+            r->put(b, x);
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // Owner side, LIFO. nullptr if empty.
+        T* pop() {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Ring* r = ring.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_seq_cst);
+
+            if (t > b) {  // empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            T* x = r->get(b);
+            if (t == b) {  // last one, race against the thieves
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { x = nullptr; }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return x;
+        }
+
+        // Thief side, FIFO. nullptr if empty or if another thread won the race.
+        T* steal() {
+            int64_t t = top.load(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_seq_cst);
+            if (t >= b) { return nullptr; }
+
+            T* x = ring.load(std::memory_order_acquire)->get(t);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { return nullptr; }
+            return x;
+        }
+
+        bool empty() const { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+
+    private:
+        Ring* _grow(Ring* old, int64_t t, int64_t b) {
+            rings.emplace_back(new Ring(old->capacity * 2));
+            Ring* r = rings.back().get();
+            for (int64_t i = t; i < b; ++i) { r->put(i, old->get(i)); }
+            ring.store(r, std::memory_order_release);
+            return r;
+        }
+
+        alignas(64) std::atomic<int64_t> top{0};
+        alignas(64) std::atomic<int64_t> bottom{0};
+        std::atomic<Ring*> ring{nullptr};
+        std::vector<std::unique_ptr<Ring>> rings;  // owner only
+    };
+
+
+    enum class PinPolicy {
+        None,      // let the OS schedule the workers
+        Cores,     // worker i on the i-th CPU of the process affinity mask (round robin)
+        NumaNodes  // worker i on all the CPUs of NUMA node i % nnodes (Linux sysfs), Cores if unavailable
+    };
+
+    class TaskGroup;
+
+    class ThreadPool : private NonCopyable<ThreadPool> {
+        friend class TaskGroup;
+
+        struct Task {
+            std::function<void()> fn;
+            TaskGroup* group;
+        };
+
+        struct alignas(64) Worker {
+            WorkStealingDeque<Task> deque;
+            std::thread thread;
+        };
+
+    public:
+        /**
+         * @brief Pool with nworkers threads (0 is valid: tasks are then run by the threads waiting on them).
+         */
+        explicit ThreadPool(unsigned nworkers, PinPolicy pin = PinPolicy::None) : workers(nworkers) {
+            const auto cpu_sets = _cpu_sets(pin, nworkers);
+            for (unsigned id = 0; id < nworkers; ++id) {
+                workers[id].thread = std::thread([this, id, cpus = cpu_sets.empty() ? std::vector<int>() : cpu_sets[id]] {
+                    _pin_current(cpus);
+                    _worker_loop(id);
+                });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(idle_mtx);
+                stop = true;
+            }
+            idle_cv.notify_all();
+            for (auto& w : workers) { w.thread.join(); }
+        }
+
+        // Number of worker threads.
+        unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+        // Threads that can run tasks at the same time: the workers and one waiting thread.
+        unsigned concurrency() const { return size() + 1; }
+
+        /**
+         * @brief Id of the calling thread in [0, size()) for the workers of this pool, size() for any other thread
+         * (e.g. the one that waits on a TaskGroup). Used to index WorkerLocal.
+         */
+        unsigned worker_id() const { return tl_pool() == this ? tl_id() : size(); }
+
+    private:
+        static const ThreadPool*& tl_pool() {
+            thread_local const ThreadPool* pool = nullptr;
+            return pool;
+        }
+
+        static unsigned& tl_id() {
+            thread_local unsigned id = 0;
+            return id;
+        }
+
+        void _submit(Task* task) {
+            pending.fetch_add(1, std::memory_order_seq_cst);  // before the push, so that it never underflows
+            if (tl_pool() == this) {
+                workers[tl_id()].deque.push(task);
+            } else {
+                std::lock_guard<std::mutex> lock(inject_mtx);
+                injected.push_back(task);
+            }
+            if (sleepers.load(std::memory_order_seq_cst) > 0) {
+                { std::lock_guard<std::mutex> lock(idle_mtx); }
+                idle_cv.notify_one();
+            }
+        }
+
+        Task* _take(unsigned id) {
+            Task* task = nullptr;
+            if (id < size()) { task = workers[id].deque.pop(); }
+            if (task == nullptr && pending.load(std::memory_order_relaxed) > 0) {
+                {
+                    std::lock_guard<std::mutex> lock(inject_mtx);
+                    if (!injected.empty()) {
+                        task = injected.front();
+                        injected.pop_front();
+                    }
+                }
+                for (unsigned k = 1; task == nullptr && k <= size(); ++k) { task = workers[(id + k) % size()].deque.steal(); }
+            }
+            if (task != nullptr) { pending.fetch_sub(1, std::memory_order_relaxed); }
+            return task;
+        }
+
+        inline void _run(Task* task);
+
+        // Run one task if any is available, from the point of view of the calling thread.
+        bool _run_one() {
+            Task* task = _take(worker_id());
+            if (task == nullptr) { return false; }
+            _run(task);
+            return true;
+        }
+
+        void _worker_loop(unsigned id) {
+            tl_pool() = this;
+            tl_id() = id;
+            while (true) {
+                if (Task* task = _take(id)) {
+                    _run(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(idle_mtx);
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                idle_cv.wait(lock, [this] { return stop || pending.load(std::memory_order_seq_cst) > 0; });
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                if (stop && pending.load(std::memory_order_relaxed) == 0) { return; }
+            }
+        }
+
+        static std::vector<int> _parse_cpulist(const std::string& list) {
+            std::vector<int> cpus;
+            const char* p = list.data();
+            const char* end = list.data() + list.size();
+            while (p < end) {
+                int first = 0, last = 0;
+                auto res = std::from_chars(p, end, first);
+                if (res.ec != std::errc()) { break; }
+                last = first;
+                p = res.ptr;
+                if (p < end && *p == '-') { p = std::from_chars(p + 1, end, last).ptr; }
+                for (int c = first; c <= last; ++c) { cpus.push_back(c); }
+                if (p < end && *p == ',') { ++p; }
+                else { break; }
+            }
+            return cpus;
+        }
+
+        // CPUs of each worker, empty if the workers are not pinned.
+        static std::vector<std::vector<int>> _cpu_sets(PinPolicy pin, unsigned nworkers) {
+            std::vector<std::vector<int>> sets;
+#ifdef __linux__
+            if (pin == PinPolicy::None || nworkers == 0) { return sets; }
+
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(mask), &mask) != 0) { return sets; }
+            std::vector<int> allowed;
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &mask)) { allowed.push_back(c); }
+            }
+            if (allowed.empty()) { return sets; }
+
+            std::vector<std::vector<int>> nodes;
+            if (pin == PinPolicy::NumaNodes) {
+                for (int node = 0;; ++node) {
+                    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    if (!in) { break; }
+                    std::string list;
+                    std::getline(in, list);
+                    std::vector<int> cpus;
+                    for (int c : _parse_cpulist(list)) {
+                        if (c < CPU_SETSIZE && CPU_ISSET(c, &mask)) { cpus.push_back(c); }
+                    }
+                    if (!cpus.empty()) { nodes.push_back(std::move(cpus)); }
+                }
+            }
+
+            for (unsigned id = 0; id < nworkers; ++id) {
+                if (!nodes.empty()) {
+                    sets.push_back(nodes[id % nodes.size()]);
+                } else {
+                    sets.push_back({allowed[id % allowed.size()]});
+                }
+            }
+#else
+            (void)pin;
+            (void)nworkers;
+#endif
+            return sets;
+        }
+
+        static void _pin_current([[maybe_unused]] const std::vector<int>& cpus) {
+#ifdef __linux__
+            if (cpus.empty()) { return; }
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int c : cpus) { CPU_SET(c, &set); }
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);  // best effort
+#endif
+        }
+
+        std::vector<Worker> workers;
+
+        std::mutex inject_mtx;
+        std::deque<Task*> injected;
+
+        alignas(64) std::atomic<size_t> pending{0};  // submitted and not taken yet
+        std::atomic<unsigned> sleepers{0};
+        std::mutex idle_mtx;
+        std::condition_variable idle_cv;
+        bool stop = false;
+    };
+
+    // inline (not static) so that every translation unit shares the same pool.
+    inline ThreadPool& default_thread_pool() {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1U) - 1);
+        return pool;
+    }
+
+    /**
+     * @brief Set of tasks that can be waited for together. The first exception thrown by a task is rethrown by wait().
+     * The destructor waits as well, so the tasks can safely capture locals by reference.
+     */
+    class TaskGroup : private NonCopyable<TaskGroup> {
+        friend class ThreadPool;
+
+    public:
+        explicit TaskGroup(ThreadPool& _pool = default_thread_pool()) : pool(_pool) { }
+
+        ~TaskGroup() { _wait_all(); }
+
+        template <typename Func>
+        void run(Func&& f) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            pool._submit(new ThreadPool::Task{std::forward<Func>(f), this});
+        }
+
+        void wait() {
+            _wait_all();
+            if (error) { std::rethrow_exception(std::exchange(error, nullptr)); }
+        }
+
+        ThreadPool& get_pool() const { return pool; }
+
+    private:
+        void _wait_all() {
+            while (count.load(std::memory_order_acquire) > 0) {
+                if (!pool._run_one()) { std::this_thread::yield(); }
+            }
+        }
+
+        void _done(std::exception_ptr e) {
+            if (e) {
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if (!error) { error = e; }
+            }
+            count.fetch_sub(1, std::memory_order_release);
+        }
+
+        ThreadPool& pool;
+        std::atomic<size_t> count{0};
+        std::mutex error_mtx;
+        std::exception_ptr error;
+    };
+
+    inline void ThreadPool::_run(Task* task) {
+        std::exception_ptr e;
+        try {
+            task->fn();
+        } catch (...) { e = std::current_exception(); }
+        TaskGroup* group = task->group;
+        delete task;
+        group->_done(e);
+    }
+
+    /**
+     * @brief One T per thread of a pool (cache line padded): local() is the slot of the calling thread, so workers can
+     * keep scratch buffers without locking. Can also be indexed by any other thread id, e.g. the ones of the CPLEX
+     * callbacks.
+     * NOTE: all the threads that are not workers of the pool share the last slot.
+     */
+    template <typename T>
+    class WorkerLocal {
+        struct alignas(64) Slot {
+            T value;
+        };
+
+    public:
+        explicit WorkerLocal(const ThreadPool& _pool = default_thread_pool(), const T& init = T()) : pool(&_pool), slots(_pool.concurrency(), Slot{init}) { }
+        explicit WorkerLocal(size_t nslots, const T& init = T()) : pool(nullptr), slots(nslots, Slot{init}) { }
+
+        // Only for the pool constructor, externally indexed slots have no notion of the calling thread.
+        T& local() {
+            if (pool == nullptr) { throw std::logic_error("WorkerLocal::local(): slots are not bound to a thread pool, use operator[]"); }
+            return slots[pool->worker_id()].value;
+        }
+        T& operator[](size_t id) { return slots[id].value; }
+        const T& operator[](size_t id) const { return slots[id].value; }
+        size_t size() const { return slots.size(); }
+
+        // Call f on every slot, e.g. to combine per-thread partial results.
+        template <typename Func>
+        void for_each(Func&& f) {
+            for (auto& s : slots) { f(s.value); }
+        }
+
+    private:
+        const ThreadPool* pool;
+        std::vector<Slot> slots;
+    };
+
+    /**
+     * @brief Call f(c) for each c in [0, nchunks) using up to nthreads threads of pool (the calling one included),
+     * chunks are handed out dynamically. Exceptions thrown by f are rethrown here.
+     */
+    template <typename Func>
+    void parallel_for_chunks(size_t nchunks, unsigned nthreads, Func&& f, ThreadPool& pool = default_thread_pool()) {
+        nthreads = static_cast<unsigned>(std::min<size_t>({std::max(nthreads, 1U), nchunks, pool.concurrency()}));
+        if (nthreads <= 1) {
+            for (size_t c = 0; c < nchunks; ++c) { f(c); }
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t c = next++; c < nchunks; c = next++) { f(c); }
+        };
+
+        TaskGroup group(pool);
+        for (unsigned k = 1; k < nthreads; ++k) { group.run(worker); }
+        worker();
+        group.wait();
+    }
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef CAV_TSPLIBLEXER_HPP
+#define CAV_TSPLIBLEXER_HPP
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "noexception.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Single-pass, pull-style tokenizer for TSPLIB-like files held in memory (e.g., a MappedFile view).
+     * Nothing is copied: keys and line values are string_views into the input, numbers are read with from_chars.
+     *
+     *      cav::TspLibLexer lex(file.view());
+     *      std::string_view key;
+     *      while (lex.next_key(key)) {
+     *          if (key == "DIMENSION") { dim = lex.value<int>(); }
+     *          else if (key == "NAME") { name = lex.line_value(); }
+     *          ...
+     *      }
+     */
+    class TspLibLexer {
+    public:
+        explicit TspLibLexer(std::string_view text) : begin(text.data()), cur(text.data()), end(text.data() + text.size()) { }
+
+        /**
+         * @brief Move to the next key, i.e. the first word of the next non-empty line, and consume the ':' that may
+         * follow it ("NAME : x", "NAME: x" and "NODE_COORD_SECTION" are all fine).
+         *
+         * @return false at the end of the input
+         */
+        inline bool next_key(std::string_view& key) {
+            _skip_spaces();
+            if (cur == end) { return false; }
+
+            const char* kbegin = cur;
+            while (cur != end && !_is_space(*cur) && *cur != ':') { ++cur; }
+            key = std::string_view(kbegin, cur - kbegin);
+
+            _skip_blanks();
+            if (cur != end && *cur == ':') { ++cur; }
+            return true;
+        }
+
+        // Rest of the current line, trimmed. The lexer moves to the next line.
+        inline std::string_view line_value() {
+            _skip_blanks();
+            const char* vbegin = cur;
+            while (cur != end && *cur != '\n') { ++cur; }
+            const char* vend = cur;
+            while (vend != vbegin && _is_space(vend[-1])) { --vend; }
+            return std::string_view(vbegin, vend - vbegin);
+        }
+
+        inline void skip_line() {
+            while (cur != end && *cur != '\n') { ++cur; }
+        }
+
+        /**
+         * @brief Next number, skipping any whitespace (newlines included) before it.
+         */
+        template <typename T>
+        inline T value() {
+            static_assert(std::is_arithmetic_v<T>);
+            T res{};
+            if (!try_value(res)) { _throw(std::runtime_error("Error: expected a number at byte " + std::to_string(offset()) + " of TSPLIB input.")); }
+            return res;
+        }
+
+        template <typename T>
+        inline bool try_value(T& res) {
+            _skip_spaces();
+            const auto [ptr, ec] = std::from_chars(cur, end, res);
+            if (ec != std::errc()) { return false; }
+            cur = ptr;
+            return true;
+        }
+
+        inline bool at_end() {
+            _skip_spaces();
+            return cur == end;
+        }
+
+        // Raw position, used to hand a whole section to another parser.
+        inline const char* position() const { return cur; }
+        inline void seek(const char* pos) { cur = pos; }
+        inline const char* input_end() const { return end; }
+        inline size_t offset() const { return cur - begin; }
+
+    private:
+        static inline bool _is_space(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; }
+
+        // Any whitespace.
+        inline void _skip_spaces() {
+            while (cur != end && _is_space(*cur)) { ++cur; }
+        }
+
+        // Whitespace within the current line.
+        inline void _skip_blanks() {
+            while (cur != end && *cur != '\n' && _is_space(*cur)) { ++cur; }
+        }
+
+    private:
+        const char* begin;
+        const char* cur;
+        const char* end;
+    };
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CAV_ALIGNEDALLOCATOR_HPP
+#define CAV_ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+
+#include "noexception.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Stateless STL allocator returning Align-byte aligned memory (C++17 aligned new).
+     *
+     * @tparam T
+     * @tparam Align alignment in bytes (power of two)
+     */
+    template <typename T, size_t Align = 64UL>
+    class AlignedAllocator {
+        static_assert((Align & (Align - 1)) == 0, "Alignment must be a power of two.");
+
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator() noexcept = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept { }
+
+        T* allocate(size_t n) {
+            if (n == 0) { return nullptr; }
+            T* ptr = static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align), std::nothrow));
+            if (ptr == nullptr) { _throw(std::runtime_error("Error: aligned new returned nullptr inside AlignedAllocator::allocate.")); }
+            return ptr;
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            if (ptr != nullptr) { ::operator delete(ptr, std::align_val_t(Align)); }
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Align>&) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Align>&) const noexcept {
+            return false;
+        }
+    };
+
+}  // namespace cav
+
+#endif
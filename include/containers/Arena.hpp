@@ -0,0 +1,144 @@
+#ifndef CAV_ARENA_HPP
+#define CAV_ARENA_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "NonCopyable.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Monotonic bump allocator: allocations are a pointer increment, deallocation is a no-op and everything is
+     * given back at once with reset(). Chunks are kept across resets, so after the first iteration of a solve loop no
+     * more calls to malloc are done.
+     * Not thread-safe: use one arena per thread (see thread_arena()).
+     */
+    class Arena : private NonCopyable<Arena> {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1UL << 20;
+
+        explicit Arena(size_t chunk_size_ = DEFAULT_CHUNK_SIZE) : chunk_size(chunk_size_), curr(0), offset(0) { }
+
+        Arena(Arena&&) noexcept = default;
+
+        inline void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+            assert((align & (align - 1)) == 0);
+            while (curr < chunks.size()) {
+                const auto base = reinterpret_cast<uintptr_t>(chunks[curr].get());
+                const uintptr_t ptr = (base + offset + align - 1) & ~(align - 1);
+                if (ptr + bytes <= base + sizes[curr]) {
+                    offset = ptr + bytes - base;
+                    return reinterpret_cast<void*>(ptr);
+                }
+                ++curr;  // the remaining of this chunk is wasted until the next reset
+                offset = 0;
+            }
+            _add_chunk(bytes + align);
+            return allocate(bytes, align);
+        }
+
+        // Free every allocation made so far, keeping the memory for the next ones.
+        inline void reset() {
+            curr = 0;
+            offset = 0;
+        }
+
+        // Give all the memory back to the system.
+        inline void release() {
+            chunks.clear();
+            sizes.clear();
+            reset();
+        }
+
+        // Bytes handed out since the last reset (alignment padding included).
+        inline size_t used() const {
+            size_t tot = offset;
+            for (size_t c = 0; c < curr && c < sizes.size(); ++c) { tot += sizes[c]; }
+            return tot;
+        }
+
+        inline size_t reserved() const {
+            size_t tot = 0;
+            for (size_t s : sizes) { tot += s; }
+            return tot;
+        }
+
+    private:
+        inline void _add_chunk(size_t min_bytes) {
+            const size_t bytes = std::max(chunk_size, min_bytes);
+            chunks.emplace_back(new std::byte[bytes]);
+            sizes.emplace_back(bytes);
+            curr = chunks.size() - 1;
+            offset = 0;
+        }
+
+    private:
+        size_t chunk_size;
+        std::vector<std::unique_ptr<std::byte[]>> chunks;
+        std::vector<size_t> sizes;
+        size_t curr;
+        size_t offset;
+    };
+
+    // Arena of the calling thread, to be reset by the owner of the thread at the end of each iteration.
+    inline Arena& thread_arena() {
+        thread_local Arena arena;
+        return arena;
+    }
+
+    /**
+     * @brief STL adapter over an Arena. A default constructed allocator uses the calling thread's arena.
+     *
+     * @tparam T
+     * @tparam Align minimum alignment of the returned memory (e.g., 64 for Flat2DVector rows)
+     */
+    template <typename T, size_t Align = alignof(std::max_align_t)>
+    class ArenaAllocator {
+        template <typename U, size_t A>
+        friend class ArenaAllocator;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = ArenaAllocator<U, Align>;
+        };
+
+        ArenaAllocator() noexcept : arena(&thread_arena()) { }
+        ArenaAllocator(Arena& arena_) noexcept : arena(&arena_) { }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U, Align>& other) noexcept : arena(other.arena) { }
+
+        inline T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), std::max(Align, alignof(T)))); }
+
+        inline void deallocate(T*, size_t) noexcept { }
+
+        inline Arena& get_arena() const { return *arena; }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U, Align>& other) const noexcept {
+            return arena == other.arena;
+        }
+
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U, Align>& other) const noexcept {
+            return arena != other.arena;
+        }
+
+    private:
+        Arena* arena;
+    };
+
+}  // namespace cav
+
+#endif
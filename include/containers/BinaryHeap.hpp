@@ -1,16 +1,89 @@
 #ifndef CAV_BINARYHEAP_HPP
 #define CAV_BINARYHEAP_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "functors.hpp"
+#include "noexception.hpp"
 
 #define LEFT(X) (2 * (X) + 1)
 #define RIGHT(X) (2 * (X) + 2)
 #define PARENT(X) (((X)-1) / 2)
 
 namespace cav {
+
+    // GetIdx/SetIdx (and Updt) policy for elements that do not track their heap position (no update/remove by element).
+    struct NoHeapIdx {
+        template <typename U>
+        void operator()(U&&, int) const { }
+        template <typename U>
+        int operator()(const U&) const {
+            return -1;
+        }
+    };
+
+    ///////// INSTRUMENTATION POLICIES /////////
+    struct HeapStats {
+        size_t upsift_steps = 0;
+        size_t heapify_steps = 0;
+        size_t cmp_calls = 0;
+        size_t setidx_calls = 0;
+        size_t max_size = 0;
+    };
+
+    // Default policy: every hook is empty and the policy is an empty base, so it costs nothing.
+    struct NoHeapStats {
+        inline void count_upsift() { }
+        inline void count_heapify() { }
+        inline void count_cmp() { }
+        inline void count_setidx() { }
+        inline void track_size(size_t) { }
+        inline void reset_stats() { }
+        inline HeapStats get_stats() const { return HeapStats(); }
+    };
+
+    // Counts sift steps (one per level moved), Cmp and SetIdx calls and the largest size reached.
+    struct CountHeapStats {
+        inline void count_upsift() { ++s.upsift_steps; }
+        inline void count_heapify() { ++s.heapify_steps; }
+        inline void count_cmp() { ++s.cmp_calls; }
+        inline void count_setidx() { ++s.setidx_calls; }
+        inline void track_size(size_t size) { s.max_size = std::max(s.max_size, size); }
+        inline void reset_stats() { s = HeapStats(); }
+        inline HeapStats get_stats() const { return s; }
+
+    private:
+        HeapStats s;
+    };
+
+    ///////// VALIDATION POLICIES /////////
+    // The heap is checked (O(n)) after each modifying operation for which due() is true, regardless of NDEBUG.
+    struct NoHeapCheck {
+        inline bool due() { return false; }
+    };
+
+    struct FullHeapCheck {
+        inline bool due() { return true; }
+    };
+
+    // Check one operation every N.
+    template <unsigned N>
+    struct SampledHeapCheck {
+        static_assert(N > 0);
+        inline bool due() {
+            if (++count < N) { return false; }
+            count = 0;
+            return true;
+        }
+
+    private:
+        unsigned count = 0;
+    };
+
     /**
      * @brief Binary Heap sorting the minimum first.
      *
@@ -20,17 +93,29 @@ namespace cav {
      * @tparam GetIdx   Given an element return the index in the heap
      * @tparam SetIdx   Set the index of an element
      * @tparam unheaped Constant value used to identify element not in the heap
+     * @tparam Stats    Instrumentation policy (NoHeapStats or CountHeapStats)
+     * @tparam Check    Validation policy (NoHeapCheck, SampledHeapCheck<N> or FullHeapCheck)
      */
-    template <typename T, class Cmp, class GetIdx, class SetIdx, class Updt, int unheaped = -1>
-    class BinaryHeap {
+    template <typename T, class Cmp, class GetIdx, class SetIdx, class Updt, int unheaped = -1, class Stats = NoHeapStats, class Check = NoHeapCheck>
+    class BinaryHeap : private Stats, private Check {
 
         std::vector<T> heap;
 
+        inline auto _cmp(const T& a, const T& b) {
+            Stats::count_cmp();
+            return Cmp()(a, b);
+        }
+
+        inline void _set_idx(T& elem, int idx) {
+            Stats::count_setidx();
+            SetIdx()(elem, idx);
+        }
+
         int inline min_lr(T& parent, int lindex, int rindex) {
             const int hsize = heap.size();
             int smallest = lindex;
-            if (rindex < hsize && Cmp()(heap[rindex], heap[lindex]) < 0) { smallest = rindex; }  // !! rindex < lindex always !!
-            if (smallest < hsize && Cmp()(heap[smallest], parent) < 0) { return smallest; }
+            if (rindex < hsize && _cmp(heap[rindex], heap[lindex]) < 0) { smallest = rindex; }  // !! rindex < lindex always !!
+            if (smallest < hsize && _cmp(heap[smallest], parent) < 0) { return smallest; }
 
             return unheaped;
         }
@@ -43,13 +128,14 @@ namespace cav {
             auto elem = std::move(heap[hindex]);
             while (smallest != unheaped) {
 
-                SetIdx()(heap[smallest], hindex);
+                Stats::count_heapify();
+                _set_idx(heap[smallest], hindex);
                 heap[hindex] = std::move(heap[smallest]);
                 hindex = smallest;
                 smallest = min_lr(elem, LEFT(hindex), RIGHT(hindex));
             }
 
-            SetIdx()(elem, hindex);
+            _set_idx(elem, hindex);
             heap[hindex] = std::move(elem);
         }
 
@@ -59,23 +145,26 @@ namespace cav {
 
             int pindex = hindex;
             auto elem = std::move(heap[hindex]);
-            while (hindex && Cmp()(elem, heap[pindex = PARENT(pindex)]) < 0) {
+            while (hindex && _cmp(elem, heap[pindex = PARENT(pindex)]) < 0) {
 
-                SetIdx()(heap[pindex], hindex);
+                Stats::count_upsift();
+                _set_idx(heap[pindex], hindex);
                 heap[hindex] = std::move(heap[pindex]);
                 hindex = pindex;
             }
 
-            SetIdx()(elem, hindex);
+            _set_idx(elem, hindex);
             heap[hindex] = std::move(elem);
         }
 
         bool is_heap() {
 
             const int hsize = heap.size();
-            for (int n = 0; n < hsize; ++n) {
-                const auto& t = heap[n];
-                if (int idx = GetIdx()(t); idx != n) { return false; }
+            if constexpr (!std::is_same_v<GetIdx, NoHeapIdx>) {
+                for (int n = 0; n < hsize; ++n) {
+                    const auto& t = heap[n];
+                    if (int idx = GetIdx()(t); idx != n) { return false; }
+                }
             }
 
             for (int n = 0; n < hsize; ++n) {
@@ -89,40 +178,79 @@ namespace cav {
             return true;
         }
 
+        inline void validate() {
+            if (Check::due() && !is_heap()) { _throw(std::logic_error("Error: BinaryHeap invariant violated.")); }
+        }
+
+        // replace() without the check, for the operations that validate once at the end.
+        void _replace(int hindex, T elem) {
+            assert(hindex >= 0 && hindex < static_cast<int>(heap.size()));
+
+            const auto case3 = _cmp(heap[hindex], elem);
+
+            _set_idx(heap[hindex], unheaped);
+            _set_idx(elem, hindex);
+            heap[hindex] = elem;
+
+            if (case3 > 0) {
+                upsift(hindex);
+            } else if (case3 < 0) {
+                heapify(hindex);
+            }
+        }
+
     public:
         BinaryHeap() { }
         BinaryHeap(const BinaryHeap& bh) : heap(bh.heap) { }
         BinaryHeap(BinaryHeap&& bh) : heap(std::move(bh.heap)) { }
 
         void reset() {
-            for (auto& t : heap) { SetIdx()(t, unheaped); }
+            for (auto& t : heap) { _set_idx(t, unheaped); }
             heap.clear();
         }
 
         bool empty() const { return heap.empty(); }
 
+        /**
+         * @brief Replace the content of the heap with the elements in [first, last), in O(n) (Floyd's construction).
+         */
+        template <typename It>
+        void make_heap(It first, It last) {
+            reset();
+            heap.assign(first, last);
+
+            const int hsize = heap.size();
+            for (int n = 0; n < hsize; ++n) { _set_idx(heap[n], n); }
+            for (int n = PARENT(hsize - 1); hsize > 1 && n >= 0; --n) { heapify(n); }
+            Stats::track_size(heap.size());
+
+            validate();
+        }
+
         void insert(T elem) {
 
             const int hindex = heap.size();
-            SetIdx()(elem, hindex);
+            _set_idx(elem, hindex);
             heap.emplace_back(elem);
             upsift(hindex);
+            Stats::track_size(heap.size());
 
-            assert(is_heap());
+            validate();
         }
 
         T get() {
             assert(!heap.empty());
 
-            SetIdx()(heap[0], unheaped);
             auto elem = std::move(heap[0]);
-
-            SetIdx()(heap.back(), 0);
-            heap[0] = std::move(heap.back());
+            if (heap.size() > 1) {
+                _set_idx(heap.back(), 0);
+                heap[0] = std::move(heap.back());
+            }
             heap.pop_back();
-            heapify(0);
+            if (!heap.empty()) { heapify(0); }
+            _set_idx(elem, unheaped);
 
-            assert(is_heap());
+            validate();
             return elem;
         }
 
@@ -131,37 +259,29 @@ namespace cav {
             if (hindex < static_cast<int>(heap.size()) - 1) {
                 auto last = std::move(heap.back());
                 heap.pop_back();
-                replace(hindex, std::move(last));
+                _replace(hindex, std::move(last));
             } else {
-                SetIdx()(heap[hindex], unheaped);
+                _set_idx(heap[hindex], unheaped);
                 heap.pop_back();
             }
 
-            assert(is_heap());
+            validate();
         }
 
         void replace(int hindex, T elem) {
-            assert(hindex >= 0 && hindex < static_cast<int>(heap.size()));
-
-            const auto case3 = Cmp()(heap[hindex], elem);
-
-            SetIdx()(heap[hindex], unheaped);
-            SetIdx()(elem, hindex);
-            heap[hindex] = elem;
-
-            if (case3 > 0) {
-                upsift(hindex);
-            } else if (case3 < 0) {
-                heapify(hindex);
-            }
-
-            assert(is_heap());
+            _replace(hindex, std::move(elem));
+            validate();
         }
 
         auto size() const { return heap.size(); }
 
         T& spy(int hindex) { return heap[hindex]; }
 
+        // Counters of the Stats policy (all zero with NoHeapStats).
+        HeapStats stats() const { return Stats::get_stats(); }
+
+        void reset_stats() { Stats::reset_stats(); }
+
         template <typename... Args>
         void update(int hindex, Args&&... args) {
             assert(hindex >= 0 && hindex < static_cast<int>(heap.size()));
@@ -174,7 +294,7 @@ namespace cav {
                 heapify(hindex);
             }
 
-            assert(is_heap());
+            validate();
         }
     };
 
@@ -197,16 +317,22 @@ namespace cav {
 
     template <typename N, auto field>
     struct UpdtFieldStruct {
-        auto operator()(N& r1, typename std::decay<decltype(std::declval<N>().*field)>::type val) {
+        auto operator()(N& r1, typename get_field_type<N, field>::type val) {
             const auto res = get_field_ref<N, field>()(r1) - val;
             get_field_ref<N, field>()(r1) = val;
             return res;
         }
     };
 
-    template <typename N, auto fidx, auto fval>
-    class BinaryHeapStruct : public BinaryHeap<N, CmpFieldStruct<N, fval>, GetIdxFieldStruct<N, fidx>, SetIdxFieldStruct<N, fidx>, UpdtFieldStruct<N, fval>> {
-    };
+    template <typename N, auto fidx, auto fval, class Stats = NoHeapStats, class Check = NoHeapCheck>
+    class BinaryHeapStruct
+        : public BinaryHeap<N, CmpFieldStruct<N, fval>, GetIdxFieldStruct<N, fidx>, SetIdxFieldStruct<N, fidx>, UpdtFieldStruct<N, fval>, -1, Stats, Check> { };
+
+
+    // Same policies, applied to proxy references (e.g. SoAVector::RowRef) that specialize get_field_ref/get_field_type.
+    template <typename Ref, auto fidx, auto fval, class Stats = NoHeapStats, class Check = NoHeapCheck>
+    class BinaryHeapProxy
+        : public BinaryHeap<Ref, CmpFieldStruct<Ref, fval>, GetIdxFieldStruct<Ref, fidx>, SetIdxFieldStruct<Ref, fidx>, UpdtFieldStruct<Ref, fval>, -1, Stats, Check> { };
 
 
     ///////// SPECIALIZATION FOR POINTERS TO STRUCT /////////
@@ -235,8 +361,8 @@ namespace cav {
         }
     };
 
-    template <typename N, auto fidx, auto fval>
-    class BinaryHeapPtr : public BinaryHeap<N*, CmpFieldPtr<N, fval>, GetIdxFieldPtr<N, fidx>, SetIdxFieldPtr<N, fidx>, UpdtFieldPtr<N, fval>> { };
+    template <typename N, auto fidx, auto fval, class Stats = NoHeapStats, class Check = NoHeapCheck>
+    class BinaryHeapPtr : public BinaryHeap<N*, CmpFieldPtr<N, fval>, GetIdxFieldPtr<N, fidx>, SetIdxFieldPtr<N, fidx>, UpdtFieldPtr<N, fval>, -1, Stats, Check> { };
 
 }  // namespace cav
 #endif
\ No newline at end of file
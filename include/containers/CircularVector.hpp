@@ -1,5 +1,5 @@
 /**
- * Circular vector that tries to mimic the structure of stl containers, alowing the use of custom allocators.
+ * Circular vector (double-ended) that tries to mimic the structure of stl containers, alowing the use of custom allocators.
  *
  * NOTE: All the following std::uninitialized_stuff are ok with allocators that simply place stuff into preallocated memory with new(memory).
  * In case of a more exotic custom allocator, these parts need to be updated to use the construct/destroy of the allocator.
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <iostream>
 #include <memory>
+#include <utility>
 
 namespace cav {
 
@@ -47,13 +48,13 @@ namespace cav {
     public:
         ArrayProxy(T* begin_, T* end_) : b(begin_), e(end_) { }
 
-        T* begin() { return b; }
+        T* begin() const { return b; }
 
-        T* end() { return e; }
+        T* end() const { return e; }
 
         size_t size() const { return e - b; }
 
-        T& operator[](size_t i) { return b[i]; }
+        T& operator[](size_t i) const { return b[i]; }
 
     private:
         T* b;
@@ -103,82 +104,172 @@ namespace cav {
             const size_t cm1;
         };
 
-        explicit CircularVector(const CircularVector& cv) : Alloc(cv), h(cv.h), t(cv.t), cm1(cv.cm1), v(Alloc::allocate(cm1 + 1)) {
-            std::uninitialized_copy(cv.v, cv.v + cv.cm1 + 1, v);
+        CircularVector(const CircularVector& cv)
+            : Alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(cv)),
+              h(cv.size()),
+              t(0),
+              cm1(cv.cm1),
+              v(Alloc::allocate(cm1 + 1)) {
+            _copy_halves(cv);
         }
 
-        explicit CircularVector(CircularVector&& cv) noexcept
-            : Alloc(cv), h(std::exchange(cv.h, 0)), t(std::exchange(cv.t, 0)), cm1(std::exchange(cv.cm1, 0)), v(std::exchange(cv.v, nullptr)) { }
+        CircularVector(CircularVector&& cv) noexcept
+            : Alloc(std::move(static_cast<Alloc&>(cv))),
+              h(std::exchange(cv.h, 0)),
+              t(std::exchange(cv.t, 0)),
+              cm1(std::exchange(cv.cm1, 0)),
+              v(std::exchange(cv.v, nullptr)) { }
 
-        explicit CircularVector(const Alloc& allocator_ = std::allocator<T>())
+        explicit CircularVector(const Alloc& allocator_ = Alloc())
             : Alloc(allocator_), h(0), t(0), cm1(INITIAL_CAPACITY - 1), v(Alloc::allocate(cm1 + 1)) { }
 
-        CircularVector(size_t size, const Alloc& allocator_ = std::allocator<T>())
+        CircularVector(size_t size, const Alloc& allocator_ = Alloc())
             : Alloc(allocator_), h(size), t(0), cm1(std::max(next_pow_2(size + 1), INITIAL_CAPACITY) - 1) {
 
             v = Alloc::allocate(cm1 + 1);
-            std::uninitialized_default_construct(v, v + cm1 + 1);
+            std::uninitialized_default_construct(v, v + size);
         }
 
-        CircularVector(size_t size, const T& value, const Alloc& allocator_ = std::allocator<T>())
+        CircularVector(size_t size, const T& value, const Alloc& allocator_ = Alloc())
             : Alloc(allocator_), h(size), t(0), cm1(std::max(next_pow_2(size + 1), INITIAL_CAPACITY) - 1) {
 
             v = Alloc::allocate(cm1 + 1);
-            std::uninitialized_fill(v, v + cm1 + 1, value);
+            std::uninitialized_fill(v, v + size, value);
         }
 
         ~CircularVector() {
-            if (t != h) {
-                std::destroy(first_half().begin(), first_half().end());
-                std::destroy(second_half().begin(), second_half().end());
-            }
-            Alloc::deallocate(v, cm1 + !!cm1);
+            clear();
+            if (v != nullptr) { Alloc::deallocate(v, cm1 + 1); }
         }
 
-        CircularVector operator=(const CircularVector& cv) = delete;
+        CircularVector& operator=(const CircularVector& cv) {
+            if (this == &cv) { return *this; }
+            clear();
+            if (cm1 < cv.size()) {
+                if (v != nullptr) { Alloc::deallocate(v, cm1 + 1); }
+                cm1 = cv.cm1;
+                v = Alloc::allocate(cm1 + 1);
+            }
+            t = 0;
+            h = cv.size();
+            _copy_halves(cv);
+            return *this;
+        }
 
-        CircularVector operator=(CircularVector&& cv) = delete;
+        CircularVector& operator=(CircularVector&& cv) noexcept {
+            if (this == &cv) { return *this; }
+            clear();
+            if (v != nullptr) { Alloc::deallocate(v, cm1 + 1); }
+            static_cast<Alloc&>(*this) = std::move(static_cast<Alloc&>(cv));
+            h = std::exchange(cv.h, 0);
+            t = std::exchange(cv.t, 0);
+            cm1 = std::exchange(cv.cm1, 0);
+            v = std::exchange(cv.v, nullptr);
+            return *this;
+        }
 
         static size_t max_size() { return Alloc::max_size(); }
 
         inline void clear() {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                std::destroy(first_half().begin(), first_half().end());
+                std::destroy(second_half().begin(), second_half().end());
+            }
             h = 0;
             t = 0;
         }
 
-        inline void push_back(const T& x) {
-            if (full()) { double_capacity(); }
-            std::allocator_traits<Alloc>::construct(*this, v + h, x);
+        inline void push_back(const T& x) { emplace_back(x); }
+
+        inline void push_back(T&& x) { emplace_back(std::move(x)); }
+
+        // Fixed-capacity mode: never grows, return false when the ring is full.
+        template <typename Tt>
+        inline bool try_push_back(Tt&& x) {
+            if (full()) { return false; }
+            std::allocator_traits<Alloc>::construct(*this, v + h, std::forward<Tt>(x));
             h = (h + 1) & cm1;
+            return true;
         }
 
-        inline void push_back(T&& x) {
+        template <typename... Args>
+        inline T& emplace_back(Args&&... args) {
             if (full()) { double_capacity(); }
-            std::allocator_traits<Alloc>::construct(*this, v + h, std::move(x));
+            T* elem = v + h;
+            std::allocator_traits<Alloc>::construct(*this, elem, std::forward<Args>(args)...);
             h = (h + 1) & cm1;
+            return *elem;
         }
 
-        T& emplace_back(const T& x) {
-            push_back(x);
-            return back();
+        inline void push_front(const T& x) { emplace_front(x); }
+
+        inline void push_front(T&& x) { emplace_front(std::move(x)); }
+
+        template <typename... Args>
+        inline T& emplace_front(Args&&... args) {
+            if (full()) { double_capacity(); }
+            const size_t t_new = (t + cm1) & cm1;
+            std::allocator_traits<Alloc>::construct(*this, v + t_new, std::forward<Args>(args)...);
+            t = t_new;
+            return v[t];
         }
 
-        T& emplace_back(T&& x) {
-            push_back(std::move(x));
-            return back();
+        /**
+         * @brief Append [first, last) growing at most once. Elements are copy constructed directly into the (at most)
+         * two contiguous free chunks; pass std::move_iterator to move them instead.
+         */
+        template <typename ForwardIt>
+        void push_back_range(ForwardIt first, ForwardIt last) {
+            const size_t n = std::distance(first, last);
+            reserve(size() + n);
+
+            const size_t n1 = std::min(n, cm1 + 1 - h);
+            ForwardIt mid = std::next(first, n1);
+            std::uninitialized_copy(first, mid, v + h);
+            std::uninitialized_copy(mid, last, v);
+            h = (h + n) & cm1;
         }
 
-        inline const T pop_front() {
+        inline T pop_front() {
             assert(!empty());
-            const auto old_t = t;
+            T elem = std::move(v[t]);
+            std::allocator_traits<Alloc>::destroy(*this, v + t);
             t = (t + 1) & cm1;
-            return std::move(v[old_t]);
+            return elem;
+        }
+
+        inline T pop_back() {
+            assert(!empty());
+            h = (h + cm1) & cm1;
+            T elem = std::move(v[h]);
+            std::allocator_traits<Alloc>::destroy(*this, v + h);
+            return elem;
         }
 
-        inline void double_capacity() { _reserve((cm1 + 1) * 2); }
+        /**
+         * @brief Move-assign the first n elements into out, then destroy them (one std::move per contiguous half).
+         *
+         * @return output iterator past the last element written
+         */
+        template <typename OutputIt>
+        OutputIt pop_front_n(size_t n, OutputIt out) {
+            assert(n <= size());
+            const size_t n1 = std::min(n, cm1 + 1 - t);
+            out = std::move(v + t, v + t + n1, out);
+            out = std::move(v, v + (n - n1), out);
+            _destroy_front(n, n1);
+            return out;
+        }
+
+        inline void double_capacity() { _reserve(std::max((cm1 + 1) * 2, INITIAL_CAPACITY)); }
 
         inline void reserve(size_t size) {
-            if (size > cm1 + 1) { _reserve(next_pow_2(size)); }
+            if (size > cm1) { _reserve(next_pow_2(size + 1)); }
+        }
+
+        inline void shrink_to_fit() {
+            const size_t new_cap = std::max(next_pow_2(size() + 1), INITIAL_CAPACITY);
+            if (new_cap < cm1 + 1) { _reserve(new_cap); }
         }
 
         inline bool empty() const { return h == t; }
@@ -187,9 +278,14 @@ namespace cav {
 
         inline size_t size() const { return ((cm1 + 1) + h - t) & cm1; }
 
+        inline size_t capacity() const { return cm1; }
+
         inline T& back() { return v[(h + cm1) & cm1]; }
         inline const T& back() const { return v[(h + cm1) & cm1]; }
 
+        inline T& front() { return v[t]; }
+        inline const T& front() const { return v[t]; }
+
         inline T& operator[](size_t n) { return v[(t + n) & cm1]; }
         inline const T& operator[](size_t n) const { return v[(t + n) & cm1]; }
 
@@ -197,9 +293,9 @@ namespace cav {
 
         inline auto end() { return circular_iterator(v, h, cm1); }
 
-        inline auto first_half() { return ArrayProxy<T>(v + t, v + (t < h ? h : cm1 + 1)); }
+        inline auto first_half() const { return ArrayProxy<T>(v + t, v + (t <= h ? h : cm1 + 1)); }
 
-        inline auto second_half() { return ArrayProxy<T>(v + static_cast<size_t>(t < h) * h, v + h); }
+        inline auto second_half() const { return ArrayProxy<T>(v + static_cast<size_t>(t <= h) * h, v + h); }
 
         void print() {
             for (const auto i : *this) { std::cout << i << " "; }
@@ -216,14 +312,30 @@ namespace cav {
 
             std::uninitialized_move(first_half().begin(), first_half().end(), v_new);
             std::uninitialized_move(second_half().begin(), second_half().end(), v_new + size1);
+            clear();
 
-            Alloc::deallocate(v, cm1 + 1);
+            if (v != nullptr) { Alloc::deallocate(v, cm1 + 1); }
             t = 0UL;
             v = v_new;
             h = h_new;
             cm1 = cm1_new;
         }
 
+        // Copy the live elements of cv at the beginning of the (uninitialized) buffer.
+        inline void _copy_halves(const CircularVector& cv) {
+            auto fh = cv.first_half();
+            auto sh = cv.second_half();
+            std::uninitialized_copy(sh.begin(), sh.end(), std::uninitialized_copy(fh.begin(), fh.end(), v));
+        }
+
+        inline void _destroy_front(size_t n, size_t n1) {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                std::destroy(v + t, v + t + n1);
+                std::destroy(v, v + (n - n1));
+            }
+            t = (t + n) & cm1;
+        }
+
     private:
         size_t h;
         size_t t;
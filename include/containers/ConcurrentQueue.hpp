@@ -0,0 +1,275 @@
+/**
+ * Bounded lock-free queues built on the same power-of-two ring used by CircularVector.
+ *
+ * Head and tail are monotonic counters (they never wrap in practice with 64 bits) that are masked with cm1 only
+ * when accessing the buffer, so full/empty can be told apart without wasting a slot.
+ * All the slots are default constructed at creation time: push/pop move-assign into/from them, which makes the
+ * batch spans returned by the batch API always point to live objects.
+ *
+ * NOTE: Counters are padded to different cache lines to avoid false sharing between producers and consumers.
+ */
+
+#ifndef CAV_CONCURRENTQUEUE_HPP
+#define CAV_CONCURRENTQUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+#include "CircularVector.hpp"
+
+namespace cav {
+
+    static constexpr size_t CACHE_LINE_SIZE = 64UL;
+
+    /**
+     * @brief Batch of contiguous (modulo wrap-around) slots owned by the caller until it is committed/released.
+     * Mimics the first_half()/second_half() interface of CircularVector.
+     *
+     * @tparam T type of the elements
+     */
+    template <typename T>
+    class RingBatch {
+    public:
+        RingBatch() : v(nullptr), pos(0), n(0), cm1(0) { }
+        RingBatch(T* v_, size_t pos_, size_t n_, size_t cm1_) : v(v_), pos(pos_), n(n_), cm1(cm1_) { }
+
+        inline size_t size() const { return n; }
+        inline bool empty() const { return n == 0; }
+
+        inline T& operator[](size_t i) { return v[(pos + i) & cm1]; }
+
+        inline auto first_half() {
+            const size_t b = pos & cm1;
+            return ArrayProxy<T>(v + b, v + std::min(b + n, cm1 + 1));
+        }
+
+        inline auto second_half() {
+            const size_t b = pos & cm1;
+            return ArrayProxy<T>(v, v + (b + n > cm1 + 1 ? b + n - (cm1 + 1) : 0));
+        }
+
+        inline size_t position() const { return pos; }
+
+    private:
+        T* v;
+        size_t pos;
+        size_t n;
+        size_t cm1;
+    };
+
+    /**
+     * @brief Wait-free single-producer/single-consumer bounded queue.
+     *
+     * @tparam T        type of the elements (must be default constructible and move assignable)
+     * @tparam Alloc    allocator for the ring storage
+     */
+    template <typename T, typename Alloc = std::allocator<T>>
+    class SPSCQueue : private Alloc {
+    public:
+        explicit SPSCQueue(size_t capacity_, const Alloc& allocator_ = Alloc())
+            : Alloc(allocator_), cm1(next_pow_2(std::max<size_t>(capacity_, 2UL)) - 1), v(Alloc::allocate(cm1 + 1)) {
+            std::uninitialized_default_construct(v, v + cm1 + 1);
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        ~SPSCQueue() {
+            std::destroy(v, v + cm1 + 1);
+            Alloc::deallocate(v, cm1 + 1);
+        }
+
+        inline size_t capacity() const { return cm1 + 1; }
+
+        // Approximated when called concurrently
+        inline size_t size() const { return h.load(std::memory_order_acquire) - t.load(std::memory_order_acquire); }
+        inline bool empty() const { return size() == 0; }
+
+        ///// PRODUCER SIDE /////
+        template <typename Tt>
+        inline bool try_push_back(Tt&& x) {
+            const size_t hh = h.load(std::memory_order_relaxed);
+            if (hh - t_cache > cm1) {
+                t_cache = t.load(std::memory_order_acquire);
+                if (hh - t_cache > cm1) { return false; }
+            }
+            v[hh & cm1] = std::forward<Tt>(x);
+            h.store(hh + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Claim up to n free slots to be written in place, then call commit_back.
+        inline RingBatch<T> reserve_back(size_t n) {
+            const size_t hh = h.load(std::memory_order_relaxed);
+            if (hh + n - t_cache > cm1 + 1) { t_cache = t.load(std::memory_order_acquire); }
+            n = std::min(n, cm1 + 1 - (hh - t_cache));
+            return RingBatch<T>(v, hh, n, cm1);
+        }
+
+        inline void commit_back(const RingBatch<T>& batch) {
+            assert(batch.position() == h.load(std::memory_order_relaxed));
+            h.store(batch.position() + batch.size(), std::memory_order_release);
+        }
+
+        ///// CONSUMER SIDE /////
+        inline bool try_pop_front(T& out) {
+            const size_t tt = t.load(std::memory_order_relaxed);
+            if (tt == h_cache) {
+                h_cache = h.load(std::memory_order_acquire);
+                if (tt == h_cache) { return false; }
+            }
+            out = std::move(v[tt & cm1]);
+            t.store(tt + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Get up to n ready elements to be consumed in place, then call release_front.
+        inline RingBatch<T> peek_front(size_t n) {
+            const size_t tt = t.load(std::memory_order_relaxed);
+            if (tt + n > h_cache) { h_cache = h.load(std::memory_order_acquire); }
+            n = std::min(n, h_cache - tt);
+            return RingBatch<T>(v, tt, n, cm1);
+        }
+
+        inline void release_front(const RingBatch<T>& batch) {
+            assert(batch.position() == t.load(std::memory_order_relaxed));
+            t.store(batch.position() + batch.size(), std::memory_order_release);
+        }
+
+    private:
+        const size_t cm1;
+        T* const v;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> h{0};
+        size_t t_cache = 0;  // producer copy of t
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> t{0};
+        size_t h_cache = 0;  // consumer copy of h
+    };
+
+    /**
+     * @brief Lock-free bounded multi-producer/multi-consumer queue (Vyukov style).
+     * Each slot has a sequence number telling whether it is ready to be written (seq == pos) or read (seq == pos + 1).
+     * Batches claim a whole range of slots with a single CAS on the shared counter.
+     *
+     * @tparam T        type of the elements (must be default constructible and move assignable)
+     * @tparam Alloc    allocator for the ring storage
+     */
+    template <typename T, typename Alloc = std::allocator<T>>
+    class MPMCQueue : private Alloc {
+        using SeqAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<size_t>>;
+
+    public:
+        explicit MPMCQueue(size_t capacity_, const Alloc& allocator_ = Alloc())
+            : Alloc(allocator_), cm1(next_pow_2(std::max<size_t>(capacity_, 2UL)) - 1), v(Alloc::allocate(cm1 + 1)), seq(SeqAlloc(*this).allocate(cm1 + 1)) {
+            std::uninitialized_default_construct(v, v + cm1 + 1);
+            for (size_t i = 0; i <= cm1; ++i) { new (seq + i) std::atomic<size_t>(i); }
+        }
+
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+        ~MPMCQueue() {
+            std::destroy(v, v + cm1 + 1);
+            std::destroy(seq, seq + cm1 + 1);
+            Alloc::deallocate(v, cm1 + 1);
+            SeqAlloc(*this).deallocate(seq, cm1 + 1);
+        }
+
+        inline size_t capacity() const { return cm1 + 1; }
+
+        // Approximated when called concurrently
+        inline size_t size() const {
+            const size_t tt = t.load(std::memory_order_acquire);
+            const size_t hh = h.load(std::memory_order_acquire);
+            return hh > tt ? hh - tt : 0;
+        }
+        inline bool empty() const { return size() == 0; }
+
+        template <typename Tt>
+        inline bool try_push_back(Tt&& x) {
+            size_t pos = h.load(std::memory_order_relaxed);
+            for (;;) {
+                const size_t s = seq[pos & cm1].load(std::memory_order_acquire);
+                if (s == pos) {
+                    if (h.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+                } else if (s < pos) {
+                    return false;  // full
+                } else {
+                    pos = h.load(std::memory_order_relaxed);
+                }
+            }
+            v[pos & cm1] = std::forward<Tt>(x);
+            seq[pos & cm1].store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool try_pop_front(T& out) {
+            size_t pos = t.load(std::memory_order_relaxed);
+            for (;;) {
+                const size_t s = seq[pos & cm1].load(std::memory_order_acquire);
+                if (s == pos + 1) {
+                    if (t.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+                } else if (s < pos + 1) {
+                    return false;  // empty
+                } else {
+                    pos = t.load(std::memory_order_relaxed);
+                }
+            }
+            out = std::move(v[pos & cm1]);
+            seq[pos & cm1].store(pos + cm1 + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Claim up to n free slots to be written in place, then call commit_back.
+        inline RingBatch<T> reserve_back(size_t n) {
+            size_t pos = h.load(std::memory_order_relaxed);
+            for (;;) {
+                const size_t k = _count_ready(pos, n, 0);
+                if (k == 0) { return RingBatch<T>(); }
+                if (h.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) { return RingBatch<T>(v, pos, k, cm1); }
+            }
+        }
+
+        inline void commit_back(const RingBatch<T>& batch) {
+            const size_t pos = batch.position();
+            for (size_t i = 0; i < batch.size(); ++i) { seq[(pos + i) & cm1].store(pos + i + 1, std::memory_order_release); }
+        }
+
+        // Get up to n ready elements to be consumed in place, then call release_front.
+        inline RingBatch<T> peek_front(size_t n) {
+            size_t pos = t.load(std::memory_order_relaxed);
+            for (;;) {
+                const size_t k = _count_ready(pos, n, 1);
+                if (k == 0) { return RingBatch<T>(); }
+                if (t.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) { return RingBatch<T>(v, pos, k, cm1); }
+            }
+        }
+
+        inline void release_front(const RingBatch<T>& batch) {
+            const size_t pos = batch.position();
+            for (size_t i = 0; i < batch.size(); ++i) { seq[(pos + i) & cm1].store(pos + i + cm1 + 1, std::memory_order_release); }
+        }
+
+    private:
+        // Number of consecutive slots starting from pos whose sequence is pos + i + offset (at most n).
+        inline size_t _count_ready(size_t pos, size_t n, size_t offset) const {
+            n = std::min(n, cm1 + 1);
+            size_t k = 0;
+            while (k < n && seq[(pos + k) & cm1].load(std::memory_order_acquire) == pos + k + offset) { ++k; }
+            return k;
+        }
+
+    private:
+        const size_t cm1;
+        T* const v;
+        std::atomic<size_t>* const seq;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> h{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> t{0};
+    };
+
+}  // namespace cav
+
+#endif
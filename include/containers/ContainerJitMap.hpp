@@ -2,6 +2,11 @@
 #define CAV_VECTORJITTRANSFORM_HPP
 
 #include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "PtrIteratorWrap.hpp"
@@ -9,15 +14,301 @@
 
 namespace cav {
 
+    template <typename View>
+    class LazyIterator;
+
+    template <typename Base, typename F>
+    class MapView;
+
+    template <typename A, typename B, typename F>
+    class ZipView;
+
+    template <typename Base, typename IdxIt>
+    class GatherView;
+
+    template <typename Base>
+    class StrideView;
+
+    template <typename Base, typename Pred, typename F>
+    class FilterView;
+
+    template <typename IterT>
+    class LazyRange;
+
+    struct lazy_identity {
+        template <typename X>
+        constexpr X operator()(X x) const noexcept { return x; }
+    };
+
+    /**
+     * @brief CRTP base of the lazy views: Derived provides operator[](size_t) const and size() const, every stage
+     * stores the previous one by value and calls it in its own operator[], so a pipeline like
+     * make_lazy(costs).zip(lambdas, f).map(g).materialize_into(out) is a single loop over the indices (no
+     * temporaries), that the compiler can inline and vectorize.
+     *
+     * @tparam Derived
+     */
+    template <typename Derived>
+    class LazyView {
+    public:
+        // Stage applying f to each element.
+        template <typename F>
+        auto map(F f) const {
+            return MapView<Derived, F>(self(), std::move(f));
+        }
+
+        // Stage combining the i-th elements of this and other (a lazy view or a container) with f.
+        template <typename Other, typename F>
+        auto zip(const Other& other, F f) const;
+
+        // Only the elements satisfying pred (not random access anymore).
+        template <typename Pred>
+        auto filter(Pred pred) const {
+            return FilterView<Derived, Pred, lazy_identity>(self(), std::move(pred), lazy_identity());
+        }
+
+        // The elements at positions [idx_first, idx_last), e.g. the rows of a column in matval.
+        template <typename IdxIt>
+        auto gather(IdxIt idx_first, IdxIt idx_last) const {
+            return GatherView<Derived, IdxIt>(self(), idx_first, idx_last);
+        }
+
+        // Elements offset, offset + step, offset + 2 * step, ...
+        auto stride(size_t step, size_t offset = 0) const { return StrideView<Derived>(self(), step, offset); }
+
+        /**
+         * @brief Evaluate the pipeline writing the elements to out[0..size()).
+         *
+         * @return out + size()
+         */
+        template <typename OutIt>
+        OutIt materialize_into(OutIt out) const {
+            const Derived& v = self();
+            const auto n = static_cast<std::ptrdiff_t>(v.size());
+            for (std::ptrdiff_t i = 0; i < n; ++i) { out[i] = v[i]; }
+            return out + n;
+        }
+
+        template <typename T, typename Op = std::plus<>>
+        T reduce(T init, Op op = Op()) const {
+            const Derived& v = self();
+            const size_t n = v.size();
+            for (size_t i = 0; i < n; ++i) { init = op(init, v[i]); }
+            return init;
+        }
+
+        template <typename F>
+        void for_each(F&& f) const {
+            const Derived& v = self();
+            const size_t n = v.size();
+            for (size_t i = 0; i < n; ++i) { f(v[i]); }
+        }
+
+        auto begin() const { return LazyIterator<Derived>(&self(), 0); }
+        auto end() const { return LazyIterator<Derived>(&self(), self().size()); }
+
+    private:
+        const Derived& self() const { return static_cast<const Derived&>(*this); }
+    };
+
+    template <typename X>
+    constexpr bool is_lazy_view_v = std::is_base_of_v<LazyView<X>, X>;
+
+    /**
+     * @brief Random access iterator over the indices of a lazy view (dereferencing evaluates the pipeline), valid
+     * while the view it comes from is alive.
+     */
+    template <typename View>
+    class LazyIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::decay_t<decltype(std::declval<const View&>()[0])>;
+        using pointer = void;
+        using reference = value_type;
+
+        LazyIterator(const View* _view, size_t _index) : view(_view), index(_index) { }
+
+        inline decltype(auto) operator*() const { return (*view)[index]; }
+        inline decltype(auto) operator[](difference_type x) const { return (*view)[index + x]; }
+
+        inline LazyIterator& operator++() { return ++index, *this; }
+        inline LazyIterator operator++(int) { return LazyIterator(view, index++); }
+        inline LazyIterator& operator--() { return --index, *this; }
+        inline LazyIterator operator--(int) { return LazyIterator(view, index--); }
+        inline LazyIterator& operator+=(difference_type x) { return index += x, *this; }
+        inline LazyIterator& operator-=(difference_type x) { return index -= x, *this; }
+        inline LazyIterator operator+(difference_type x) const { return LazyIterator(view, index + x); }
+        inline LazyIterator operator-(difference_type x) const { return LazyIterator(view, index - x); }
+        inline difference_type operator-(LazyIterator x) const { return static_cast<difference_type>(index) - static_cast<difference_type>(x.index); }
+
+        inline bool operator==(LazyIterator x) const { return index == x.index; }
+        inline bool operator!=(LazyIterator x) const { return index != x.index; }
+        inline bool operator<(LazyIterator x) const { return index < x.index; }
+        inline bool operator>(LazyIterator x) const { return index > x.index; }
+        inline bool operator<=(LazyIterator x) const { return index <= x.index; }
+        inline bool operator>=(LazyIterator x) const { return index >= x.index; }
+
+    private:
+        const View* view;
+        size_t index;
+    };
+
+    /**
+     * @brief Source stage: a random access range [first, last), elements are returned as they are.
+     */
+    template <typename IterT>
+    class LazyRange : public LazyView<LazyRange<IterT>> {
+    public:
+        LazyRange(IterT _first, IterT _last) : first(_first), last(_last) { }
+
+        inline decltype(auto) operator[](size_t index) const { return first[index]; }
+        inline size_t size() const { return static_cast<size_t>(std::distance(first, last)); }
+
+    private:
+        IterT first;
+        IterT last;
+    };
+
+    template <typename IterT>
+    auto make_lazy(IterT first, IterT last) {
+        return LazyRange<IterT>(first, last);
+    }
+
+    // Containers are wrapped by their iterators (no copy), lazy views are taken as they are.
+    template <typename Cont>
+    auto make_lazy(const Cont& cont) {
+        if constexpr (is_lazy_view_v<Cont>) {
+            return cont;
+        } else {
+            return LazyRange<decltype(std::begin(cont))>(std::begin(cont), std::end(cont));
+        }
+    }
+
+    template <typename Base, typename F>
+    class MapView : public LazyView<MapView<Base, F>> {
+    public:
+        MapView(Base _base, F _f) : base(std::move(_base)), f(std::move(_f)) { }
+
+        inline decltype(auto) operator[](size_t index) const { return f(base[index]); }
+        inline size_t size() const { return static_cast<size_t>(base.size()); }
+
+    private:
+        Base base;
+        F f;
+    };
+
+    template <typename A, typename B, typename F>
+    class ZipView : public LazyView<ZipView<A, B, F>> {
+    public:
+        ZipView(A _a, B _b, F _f) : a(std::move(_a)), b(std::move(_b)), f(std::move(_f)) { assert(static_cast<size_t>(a.size()) == static_cast<size_t>(b.size())); }
+
+        inline decltype(auto) operator[](size_t index) const { return f(a[index], b[index]); }
+        inline size_t size() const { return static_cast<size_t>(a.size()); }
+
+    private:
+        A a;
+        B b;
+        F f;
+    };
+
+    template <typename Derived>
+    template <typename Other, typename F>
+    auto LazyView<Derived>::zip(const Other& other, F f) const {
+        auto other_view = make_lazy(other);
+        return ZipView<Derived, decltype(other_view), F>(self(), std::move(other_view), std::move(f));
+    }
+
+    template <typename Base, typename IdxIt>
+    class GatherView : public LazyView<GatherView<Base, IdxIt>> {
+    public:
+        GatherView(Base _base, IdxIt _idx_first, IdxIt _idx_last) : base(std::move(_base)), idx_first(_idx_first), idx_last(_idx_last) { }
+
+        inline decltype(auto) operator[](size_t index) const { return base[static_cast<size_t>(idx_first[index])]; }
+        inline size_t size() const { return static_cast<size_t>(std::distance(idx_first, idx_last)); }
+
+    private:
+        Base base;
+        IdxIt idx_first;
+        IdxIt idx_last;
+    };
+
+    template <typename Base>
+    class StrideView : public LazyView<StrideView<Base>> {
+    public:
+        StrideView(Base _base, size_t _step, size_t _offset) : base(std::move(_base)), step(_step), offset(_offset) { assert(step > 0); }
+
+        inline decltype(auto) operator[](size_t index) const { return base[offset + index * step]; }
+        inline size_t size() const {
+            const auto n = static_cast<size_t>(base.size());
+            return n > offset ? (n - offset + step - 1) / step : 0;
+        }
+
+    private:
+        Base base;
+        size_t step;
+        size_t offset;
+    };
+
+    /**
+     * @brief Elements of Base satisfying Pred, transformed by F. The output size is known only after a pass, so this
+     * stage has no operator[]: map() composes into F, the other operations are terminal.
+     */
+    template <typename Base, typename Pred, typename F>
+    class FilterView {
+    public:
+        FilterView(Base _base, Pred _pred, F _f) : base(std::move(_base)), pred(std::move(_pred)), f(std::move(_f)) { }
+
+        template <typename G>
+        auto map(G g) const {
+            auto fg = [f = f, g = std::move(g)](auto&& x) -> decltype(auto) { return g(f(std::forward<decltype(x)>(x))); };
+            return FilterView<Base, Pred, decltype(fg)>(base, pred, std::move(fg));
+        }
+
+        template <typename Fn>
+        void for_each(Fn&& fn) const {
+            const size_t n = static_cast<size_t>(base.size());
+            for (size_t i = 0; i < n; ++i) {
+                decltype(auto) x = base[i];
+                if (pred(x)) { fn(f(x)); }
+            }
+        }
+
+        // Write the selected elements to out (that needs room for up to base.size() of them), return the end.
+        template <typename OutIt>
+        OutIt materialize_into(OutIt out) const {
+            for_each([&out](auto&& x) { *out++ = std::forward<decltype(x)>(x); });
+            return out;
+        }
+
+        template <typename T, typename Op = std::plus<>>
+        T reduce(T init, Op op = Op()) const {
+            for_each([&](auto&& x) { init = op(init, std::forward<decltype(x)>(x)); });
+            return init;
+        }
+
+        size_t count() const {
+            size_t n = 0;
+            const size_t bsize = static_cast<size_t>(base.size());
+            for (size_t i = 0; i < bsize; ++i) { n += static_cast<bool>(pred(base[i])); }
+            return n;
+        }
+
+    private:
+        Base base;
+        Pred pred;
+        F f;
+    };
+
     /**
      * @brief Apply a function to a random access range online, without modifying
-     * the underlying values.
+     * the underlying values. Being a LazyView, further map/zip/filter/gather/stride stages can be chained on it.
      *
      * @tparam IterT
      * @tparam UnaryOp
      */
     template <typename IterT, template <typename T> class OpTmpl = identity_functor>
-    class ContainerJitMap {
+    class ContainerJitMap : public LazyView<ContainerJitMap<IterT, OpTmpl>> {
         using T = typename std::iterator_traits<IterT>::value_type;
         using UnaryOp = OpTmpl<T>;
 
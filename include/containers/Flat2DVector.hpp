@@ -1,6 +1,14 @@
 #ifndef _FLAT2DVECTOR_HPP
 #define _FLAT2DVECTOR_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
 #include "RandomIterator.hpp"
 #include "VectorView.hpp"
 #include "functors.hpp"
@@ -8,14 +16,43 @@
 
 namespace cav {
 
-    template <typename T>
-    class Flat2DVector {
+    // Rows start at this alignment (bytes), that is also the SIMD width rows are padded to.
+    static constexpr size_t FLAT2D_ALIGNMENT = 64UL;
+
+    /**
+     * @brief Row-major matrix stored in a single 64B aligned buffer. Each row is padded to a multiple of the SIMD width
+     * (when sizeof(T) divides it), so every row starts aligned and row kernels can vectorize without peeling.
+     * Padding elements are value-initialized and never exposed by Row.
+     *
+     * The storage comes from Alloc, which can be swapped for a file mapping (see MmapAllocator) or an arena.
+     * Allocators that hand out pre-filled memory are used with the (rows, cols, allocator) constructor, that leaves the
+     * content untouched.
+     *
+     * @tparam T
+     * @tparam Alloc allocator for the buffer, its memory must be FLAT2D_ALIGNMENT aligned to get aligned rows
+     */
+    template <typename T, typename Alloc = AlignedAllocator<T, FLAT2D_ALIGNMENT>>
+    class Flat2DVector : private Alloc {
+        using AllocTraits = std::allocator_traits<Alloc>;
+
 
         ///////////// DATA STRUCTURE /////////////
+    public:
+        // Row view that also knows the distance from the next row, used by the row iterators.
+        template <typename P>
+        class StridedRow : public VectorView<P> {
+        public:
+            StridedRow(P first_, size_t size_, size_t stride_) : VectorView<P>(first_, first_ + size_), row_stride(stride_) { }
+            inline size_t stride() const { return row_stride; }
+
+        private:
+            size_t row_stride;
+        };
+
     private:
         template <typename RowT>
         struct Rplus {
-            RowT operator()(RowT vv, long int i) { return RowT(vv.begin() + vv.size() * i, vv.begin() + vv.size() * (i + 1)); }
+            RowT operator()(RowT vv, long int i) { return RowT(vv.begin() + vv.stride() * i, vv.size(), vv.stride()); }
         };
 
         template <typename RowT>
@@ -25,65 +62,212 @@ namespace cav {
 
         template <typename RowT>
         struct Rminus {
-            long int operator()(RowT v1, RowT v2) { return v1.begin() - v2.begin(); }
+            long int operator()(RowT v1, RowT v2) { return (v1.begin() - v2.begin()) / static_cast<long int>(v1.stride()); }
+        };
+
+        template <typename RowT>
+        struct Rdefer {
+            RowT& operator()(RowT& vv) const { return vv; }
         };
 
+        static constexpr size_t SIMD_ELEMS = FLAT2D_ALIGNMENT % sizeof(T) == 0 ? FLAT2D_ALIGNMENT / sizeof(T) : 1UL;
+
     public:
         using Row = VectorView<T*>;
         using Const_Row = VectorView<const T*>;
-        using iterator = RandomIterator<Row, Rplus, Rless, Rminus, identity_ftor>;
-        using const_iterator = RandomIterator<Const_Row, Rplus, Rless, Rminus, identity_ftor>;
+        using iterator = RandomIterator<StridedRow<T*>, Rplus, Rless, Rminus, Rdefer>;
+        using const_iterator = RandomIterator<StridedRow<const T*>, Rplus, Rless, Rminus, Rdefer>;
+
+        // Tile side used by transpose: 32x32 doubles are 8KB, two tiles comfortably fit in L1.
+        static constexpr size_t TRANSPOSE_TILE = 32UL;
+
+        static constexpr size_t padded_cols(size_t cols_) { return (cols_ + SIMD_ELEMS - 1) / SIMD_ELEMS * SIMD_ELEMS; }
 
 
         ///////////// METHODS /////////////
     public:
-        Flat2DVector() : data(nullptr), rows(0), cols(0) { }
+        Flat2DVector(const Alloc& allocator_ = Alloc()) : Alloc(allocator_), data(nullptr), rows(0), cols(0), stride(0), capacity(0) { }
 
-        Flat2DVector(size_t rows_, size_t cols_) : data(new T[rows_ * cols_]), rows(rows_), cols(cols_) {
-            if (data == nullptr) { _throw(std::runtime_error("Error: new returned nullptr inside Flat2DVector::Flat2DVector.")); }
+        Flat2DVector(size_t rows_, size_t cols_, T val = T(), const Alloc& allocator_ = Alloc())
+            : Flat2DVector(uninitialized_tag(), rows_, cols_, allocator_) {
+            std::uninitialized_fill(data, data + capacity, val);
         }
 
-        Flat2DVector(size_t rows_, size_t cols_, T val = T()) : data(new T[rows_ * cols_]), rows(rows_), cols(cols_) {
-            if (data == nullptr) { _throw(std::runtime_error("Error: new returned nullptr inside Flat2DVector::Flat2DVector.")); }
-            std::fill(data, data + rows * cols, val);
+        /**
+         * @brief Allocate the buffer without initializing it: the content is whatever the allocator provides (e.g., the
+         * matrix stored in a mapped file).
+         */
+        Flat2DVector(size_t rows_, size_t cols_, const Alloc& allocator_) : Flat2DVector(uninitialized_tag(), rows_, cols_, allocator_) {
+            static_assert(std::is_trivially_copyable_v<T>, "Uninitialized storage only for trivially copyable types.");
+        }
+
+        Flat2DVector(const Flat2DVector& other)
+            : Alloc(AllocTraits::select_on_container_copy_construction(other)),
+              rows(other.rows),
+              cols(other.cols),
+              stride(other.stride),
+              capacity(rows * stride) {
+            data = capacity > 0 ? AllocTraits::allocate(*this, capacity) : nullptr;
+            std::uninitialized_copy(other.data, other.data + capacity, data);
+        }
+
+        Flat2DVector(Flat2DVector&& other) noexcept
+            : Alloc(std::move(static_cast<Alloc&>(other))),
+              data(std::exchange(other.data, nullptr)),
+              rows(std::exchange(other.rows, 0)),
+              cols(std::exchange(other.cols, 0)),
+              stride(std::exchange(other.stride, 0)),
+              capacity(std::exchange(other.capacity, 0)) { }
+
+        Flat2DVector& operator=(Flat2DVector other) noexcept {
+            swap(other);
+            return *this;
         }
 
-        ~Flat2DVector() { delete[] data; }
+        ~Flat2DVector() { _release(); }
 
+        inline void swap(Flat2DVector& other) noexcept {
+            std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(other));
+            std::swap(data, other.data);
+            std::swap(rows, other.rows);
+            std::swap(cols, other.cols);
+            std::swap(stride, other.stride);
+            std::swap(capacity, other.capacity);
+        }
+
+        /**
+         * @brief Change the shape discarding the content. The buffer is reused when big enough, use shrink_to_fit to
+         * give memory back.
+         */
         inline void reset(size_t rows_, size_t cols_) {
-            size_t old_size = rows * cols;
+            const size_t stride_new = padded_cols(cols_);
+            if (rows_ * stride_new > capacity) {
+                _release();
+                data = AllocTraits::allocate(*this, rows_ * stride_new);
+                capacity = rows_ * stride_new;
+                std::uninitialized_value_construct(data, data + capacity);
+            }
             rows = rows_;
             cols = cols_;
-            if (old_size > rows * cols) { return; }
-
-            delete[] data;
-            data = new T[rows * cols];
-            if (data == nullptr) { _throw(std::runtime_error("Error: new returned nullptr inside Flat2DVector::resize.")); }
+            stride = stride_new;
         }
 
         inline void reset(size_t rows_, size_t cols_, T val) {
             reset(rows_, cols_);
-            std::fill(data, data + rows * cols, val);
+            std::fill(data, data + rows * stride, val);
         }
 
-        inline Row operator[](size_t i) { return Row(data + i * cols, data + (i + 1) * cols); }
+        /**
+         * @brief Change the shape preserving the elements in the common top-left submatrix, new elements get val.
+         */
+        inline void resize(size_t rows_, size_t cols_, T val = T()) {
+            Flat2DVector res(rows_, cols_, val, static_cast<const Alloc&>(*this));
+            const size_t rmin = std::min(rows, rows_);
+            const size_t cmin = std::min(cols, cols_);
+            for (size_t i = 0; i < rmin; ++i) { std::move(data + i * stride, data + i * stride + cmin, res.data + i * res.stride); }
+            swap(res);
+        }
 
-        inline const Row operator[](size_t i) const { return Row(data + i * cols, data + (i + 1) * cols); }
+        inline void shrink_to_fit() {
+            if (capacity > rows * stride) { resize(rows, cols); }
+        }
+
+        inline Row operator[](size_t i) { return Row(data + i * stride, data + i * stride + cols); }
+
+        inline Const_Row operator[](size_t i) const { return Const_Row(data + i * stride, data + i * stride + cols); }
 
         inline T& at(size_t i, size_t j) {
             assert(i < rows && j < cols);
-            return data[i * cols + j];
+            return data[i * stride + j];
         }
         inline const T& at(size_t i, size_t j) const {
             assert(i < rows && j < cols);
-            return data[i * cols + j];
+            return data[i * stride + j];
+        }
+
+        inline size_t get_rows() const { return rows; }
+        inline size_t get_cols() const { return cols; }
+        inline size_t row_stride() const { return stride; }
+        inline T* raw_data() { return data; }
+        inline const T* raw_data() const { return data; }
+
+        /**
+         * @brief Call f(i_begin, i_end, j_begin, j_end) for each tile_rows x tile_cols block, row of tiles by row of tiles.
+         */
+        template <typename Func>
+        void for_each_tile(size_t tile_rows, size_t tile_cols, Func&& f) const {
+            for (size_t i0 = 0; i0 < rows; i0 += tile_rows) {
+                for (size_t j0 = 0; j0 < cols; j0 += tile_cols) { f(i0, std::min(i0 + tile_rows, rows), j0, std::min(j0 + tile_cols, cols)); }
+            }
         }
 
-        iterator begin() { return iterator(Row(data, data + cols)); }
-        iterator end() { return iterator(Row(data + rows * cols, data + rows * cols)); }
+        /**
+         * @brief Cache-blocked transpose: in place for square matrices (swapping mirrored tiles), through a temporary
+         * otherwise. The temporary gets the allocator a copy would get, so arenas and allocator state are kept, while
+         * a file mapping (MmapAllocator) is detached: the transposed matrix lives in anonymous memory.
+         */
+        void transpose() { transpose(_sequential_tiles()); }
+
+        /**
+         * @brief Same as transpose(), with the tiles walked by tile_loop(tile_rows, tile_cols, f), that must call f on
+         * every tile of this matrix like for_each_tile does (in any order, e.g. the parallel_for_each_tile of
+         * Flat2DParallel.hpp).
+         */
+        template <typename TileLoop>
+        void transpose(TileLoop&& tile_loop) {
+            if (rows == cols) {
+                auto swap_tiles = [this](size_t i0, size_t i1, size_t j0, size_t j1) {
+                    if (j0 < i0) { return; }  // the mirrored tile does the job
+                    for (size_t i = i0; i < i1; ++i) {
+                        for (size_t j = std::max(j0, i + 1); j < j1; ++j) { std::swap(data[i * stride + j], data[j * stride + i]); }
+                    }
+                };
+                tile_loop(TRANSPOSE_TILE, TRANSPOSE_TILE, swap_tiles);
+            } else {
+                Flat2DVector res(cols, rows, T(), AllocTraits::select_on_container_copy_construction(*this));
+                transpose_into(res, std::forward<TileLoop>(tile_loop));
+                swap(res);
+            }
+        }
 
-        const_iterator begin() const { return const_iterator(Const_Row(data, data + cols)); }
-        const_iterator end() const { return const_iterator(Const_Row(data + rows * cols, data + rows * cols)); }
+        // Write the transpose in dst (that must be get_cols() x get_rows()).
+        void transpose_into(Flat2DVector& dst) const { transpose_into(dst, _sequential_tiles()); }
+
+        template <typename TileLoop>
+        void transpose_into(Flat2DVector& dst, TileLoop&& tile_loop) const {
+            assert(dst.rows == cols && dst.cols == rows);
+            auto copy_tile = [this, &dst](size_t i0, size_t i1, size_t j0, size_t j1) {
+                for (size_t j = j0; j < j1; ++j) {
+                    for (size_t i = i0; i < i1; ++i) { dst.data[j * dst.stride + i] = data[i * stride + j]; }
+                }
+            };
+            tile_loop(TRANSPOSE_TILE, TRANSPOSE_TILE, copy_tile);
+        }
+
+        iterator begin() { return iterator(StridedRow<T*>(data, cols, stride)); }
+        iterator end() { return iterator(StridedRow<T*>(data + rows * stride, cols, stride)); }
+
+        const_iterator begin() const { return const_iterator(StridedRow<const T*>(data, cols, stride)); }
+        const_iterator end() const { return const_iterator(StridedRow<const T*>(data + rows * stride, cols, stride)); }
+
+    private:
+        struct uninitialized_tag { };
+
+        auto _sequential_tiles() const {
+            return [this](size_t tile_rows, size_t tile_cols, auto&& f) { for_each_tile(tile_rows, tile_cols, f); };
+        }
+
+        Flat2DVector(uninitialized_tag, size_t rows_, size_t cols_, const Alloc& allocator_)
+            : Alloc(allocator_), rows(rows_), cols(cols_), stride(padded_cols(cols_)), capacity(rows_ * stride) {
+            data = capacity > 0 ? AllocTraits::allocate(*this, capacity) : nullptr;
+        }
+
+        inline void _release() {
+            if constexpr (!std::is_trivially_destructible_v<T>) { std::destroy(data, data + capacity); }
+            if (data != nullptr) { AllocTraits::deallocate(*this, data, capacity); }
+            data = nullptr;
+            capacity = 0;
+        }
 
 
         ///////////// FIELDS /////////////
@@ -91,8 +275,82 @@ namespace cav {
         T* data;
         size_t rows;
         size_t cols;
+        size_t stride;
+        size_t capacity;
+    };
+
+
+    /**
+     * @brief Symmetric n x n matrix storing only the packed upper triangle (diagonal included), about half the memory
+     * of a full Flat2DVector. at(i, j) and at(j, i) refer to the same element.
+     *
+     * @tparam T
+     * @tparam Alloc allocator for the packed buffer
+     */
+    template <typename T, typename Alloc = AlignedAllocator<T, FLAT2D_ALIGNMENT>>
+    class SymFlat2DVector : private Alloc {
+
+        ///////////// METHODS /////////////
+    public:
+        using Row = VectorView<T*>;
+        using Const_Row = VectorView<const T*>;
+
+        SymFlat2DVector(const Alloc& allocator_ = Alloc()) : Alloc(allocator_), data(nullptr), n(0) { }
+
+        explicit SymFlat2DVector(size_t n_, T val = T(), const Alloc& allocator_ = Alloc())
+            : Alloc(allocator_), data(std::allocator_traits<Alloc>::allocate(*this, packed_size(n_))), n(n_) {
+            std::uninitialized_fill(data, data + packed_size(n), val);
+        }
+
+        SymFlat2DVector(const SymFlat2DVector& other)
+            : Alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other)),
+              data(std::allocator_traits<Alloc>::allocate(*this, packed_size(other.n))),
+              n(other.n) {
+            std::uninitialized_copy(other.data, other.data + packed_size(n), data);
+        }
+
+        SymFlat2DVector(SymFlat2DVector&& other) noexcept
+            : Alloc(std::move(static_cast<Alloc&>(other))), data(std::exchange(other.data, nullptr)), n(std::exchange(other.n, 0)) { }
+
+        SymFlat2DVector& operator=(SymFlat2DVector other) noexcept {
+            std::swap(static_cast<Alloc&>(*this), static_cast<Alloc&>(other));
+            std::swap(data, other.data);
+            std::swap(n, other.n);
+            return *this;
+        }
+
+        ~SymFlat2DVector() {
+            if constexpr (!std::is_trivially_destructible_v<T>) { std::destroy(data, data + packed_size(n)); }
+            if (data != nullptr) { std::allocator_traits<Alloc>::deallocate(*this, data, packed_size(n)); }
+        }
+
+        static constexpr size_t packed_size(size_t n_) { return n_ * (n_ + 1) / 2; }
+
+        // Position of (i, j), i <= j, in the packed buffer: row i starts after the n + (n-1) + ... + (n-i+1) elements above.
+        inline size_t index(size_t i, size_t j) const {
+            if (i > j) { std::swap(i, j); }
+            assert(j < n);
+            return i * (2 * n - i - 1) / 2 + j;
+        }
+
+        inline T& at(size_t i, size_t j) { return data[index(i, j)]; }
+        inline const T& at(size_t i, size_t j) const { return data[index(i, j)]; }
+
+        // Contiguous part of row i: elements (i, i), (i, i+1), ..., (i, n-1).
+        inline Row upper_row(size_t i) { return Row(data + index(i, i), data + index(i, i) + (n - i)); }
+        inline Const_Row upper_row(size_t i) const { return Const_Row(data + index(i, i), data + index(i, i) + (n - i)); }
+
+        inline size_t size() const { return n; }
+        inline T* raw_data() { return data; }
+        inline const T* raw_data() const { return data; }
+
+
+        ///////////// FIELDS /////////////
+    private:
+        T* data;
+        size_t n;
     };
 
 }  // namespace cav
 
-#endif
\ No newline at end of file
+#endif
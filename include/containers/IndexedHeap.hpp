@@ -0,0 +1,170 @@
+#ifndef CAV_INDEXEDHEAP_HPP
+#define CAV_INDEXEDHEAP_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace cav {
+
+    /**
+     * @brief Binary min-heap over dense integer ids in [0, nkeys).
+     * The heap stores (prio, id) pairs contiguously, so comparisons never leave the heap array; a separate position
+     * array maps each id to its heap slot. Nothing points into user memory, so the user containers can reallocate.
+     *
+     * @tparam Key  unsigned integral type of the ids
+     * @tparam Prio priority type
+     * @tparam Less strict ordering on Prio, the smallest is extracted first
+     */
+    template <typename Key = uint32_t, typename Prio = double, class Less = std::less<Prio>>
+    class IndexedHeap {
+        static_assert(std::is_unsigned_v<Key>, "Key must be an unsigned integral type.");
+
+    public:
+        struct Entry {
+            Prio prio;
+            Key id;
+        };
+
+        static constexpr Key NOT_IN_HEAP = std::numeric_limits<Key>::max();
+
+        IndexedHeap() = default;
+        explicit IndexedHeap(size_t nkeys) : pos(nkeys, NOT_IN_HEAP) { }
+
+        // Change the id range, the heap must be empty.
+        inline void resize(size_t nkeys) {
+            assert(heap.empty());
+            pos.assign(nkeys, NOT_IN_HEAP);
+        }
+
+        // O(size()), the position array is not scanned.
+        inline void clear() {
+            for (const Entry& e : heap) { pos[e.id] = NOT_IN_HEAP; }
+            heap.clear();
+        }
+
+        inline bool empty() const { return heap.empty(); }
+        inline size_t size() const { return heap.size(); }
+        inline size_t capacity() const { return pos.size(); }
+
+        inline bool contains(Key id) const { return pos[id] != NOT_IN_HEAP; }
+
+        inline const Entry& top() const {
+            assert(!heap.empty());
+            return heap[0];
+        }
+        inline Key top_id() const { return top().id; }
+        inline Prio top_prio() const { return top().prio; }
+
+        inline Prio prio(Key id) const {
+            assert(contains(id));
+            return heap[pos[id]].prio;
+        }
+
+        inline void push(Key id, Prio prio) {
+            assert(id < pos.size() && !contains(id));
+            heap.push_back({prio, id});
+            upsift(heap.size() - 1);
+        }
+
+        inline Entry pop() {
+            assert(!heap.empty());
+            const Entry res = heap[0];
+            pos[res.id] = NOT_IN_HEAP;
+            const Entry last = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                heap[0] = last;
+                heapify(0);
+            }
+            return res;
+        }
+
+        // New priority must not be worse than the current one.
+        inline void decrease_key(Key id, Prio prio) {
+            assert(contains(id) && !Less()(heap[pos[id]].prio, prio));
+            heap[pos[id]].prio = prio;
+            upsift(pos[id]);
+        }
+
+        // Any priority change.
+        inline void update(Key id, Prio prio) {
+            assert(contains(id));
+            const size_t hindex = pos[id];
+            const bool better = Less()(prio, heap[hindex].prio);
+            heap[hindex].prio = prio;
+            better ? upsift(hindex) : heapify(hindex);
+        }
+
+        /**
+         * @brief Dijkstra-style relaxation: insert id, or decrease its priority if prio is better.
+         *
+         * @return true if the heap changed
+         */
+        inline bool push_or_decrease(Key id, Prio prio) {
+            if (!contains(id)) {
+                push(id, prio);
+                return true;
+            }
+            if (Less()(prio, heap[pos[id]].prio)) {
+                decrease_key(id, prio);
+                return true;
+            }
+            return false;
+        }
+
+        inline void erase(Key id) {
+            assert(contains(id));
+            const size_t hindex = pos[id];
+            pos[id] = NOT_IN_HEAP;
+            const Entry last = heap.back();
+            heap.pop_back();
+            if (hindex == heap.size()) { return; }
+
+            const bool better = Less()(last.prio, heap[hindex].prio);
+            heap[hindex] = last;
+            better ? upsift(hindex) : heapify(hindex);
+        }
+
+    private:
+        inline void upsift(size_t hindex) {
+            const Entry elem = heap[hindex];
+            while (hindex > 0) {
+                const size_t pindex = (hindex - 1) / 2;
+                if (!Less()(elem.prio, heap[pindex].prio)) { break; }
+                _place(hindex, heap[pindex]);
+                hindex = pindex;
+            }
+            _place(hindex, elem);
+        }
+
+        inline void heapify(size_t hindex) {
+            const Entry elem = heap[hindex];
+            const size_t hsize = heap.size();
+            for (;;) {
+                size_t smallest = 2 * hindex + 1;
+                if (smallest >= hsize) { break; }
+                if (smallest + 1 < hsize && Less()(heap[smallest + 1].prio, heap[smallest].prio)) { ++smallest; }
+                if (!Less()(heap[smallest].prio, elem.prio)) { break; }
+                _place(hindex, heap[smallest]);
+                hindex = smallest;
+            }
+            _place(hindex, elem);
+        }
+
+        inline void _place(size_t hindex, const Entry& e) {
+            heap[hindex] = e;
+            pos[e.id] = static_cast<Key>(hindex);
+        }
+
+    private:
+        std::vector<Entry> heap;
+        std::vector<Key> pos;
+    };
+
+}  // namespace cav
+
+#endif
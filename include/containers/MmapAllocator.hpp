@@ -0,0 +1,163 @@
+/**
+ * Allocator backing a container buffer with a memory-mapped file (POSIX only).
+ *
+ * Meant for Flat2DVector matrices larger than RAM, or shared read-only across worker processes:
+ *
+ *      auto alloc = cav::MmapAllocator<float>("dist.bin", cav::MmapMode::ReadOnly, cav::MmapAdvice::Random);
+ *      const auto dist = cav::Flat2DVector<float, cav::MmapAllocator<float>>(n, n, alloc);
+ *
+ * The file stores the rows*row_stride() elements of the matrix as they are in memory (padding included).
+ *
+ * NOTE: each allocator maps its file once; a second allocate() while the mapping is alive throws, so the containers
+ * using it must not grow (reset/resize). Copying a container gives an anonymous private copy.
+ */
+
+#ifndef CAV_MMAPALLOCATOR_HPP
+#define CAV_MMAPALLOCATOR_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "noexception.hpp"
+
+namespace cav {
+
+    enum class MmapMode {
+        ReadOnly,   // PROT_READ, MAP_SHARED: the file must already contain the data
+        ReadWrite,  // PROT_READ|PROT_WRITE, MAP_SHARED: the file is created/extended, writes go to the file
+        Anonymous   // private anonymous memory, no file (same madvise hints)
+    };
+
+    enum class MmapAdvice { Normal, Sequential, Random };
+
+    template <typename T>
+    class MmapAllocator {
+        template <typename U>
+        friend class MmapAllocator;
+
+        struct State {
+            std::string path;
+            MmapMode mode;
+            MmapAdvice advice;
+            bool huge_pages;
+            bool mapped = false;
+        };
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit MmapAllocator(std::string path_, MmapMode mode_ = MmapMode::ReadOnly, MmapAdvice advice_ = MmapAdvice::Normal, bool huge_pages_ = true)
+            : state(std::make_shared<State>(State{std::move(path_), mode_, advice_, huge_pages_})) { }
+
+        // Anonymous mapping, mainly used for copies of file-backed containers.
+        MmapAllocator() : MmapAllocator(std::string(), MmapMode::Anonymous) { }
+
+        template <typename U>
+        MmapAllocator(const MmapAllocator<U>& other) noexcept : state(other.state) { }
+
+        MmapAllocator select_on_container_copy_construction() const { return MmapAllocator(std::string(), MmapMode::Anonymous, state->advice, state->huge_pages); }
+
+        T* allocate(size_t n) {
+            if (n == 0) { return nullptr; }  // mmap rejects empty mappings
+            if (state->mapped) { _throw(std::logic_error("Error: MmapAllocator::allocate called on an already mapped file: " + state->path)); }
+
+            const size_t bytes = n * sizeof(T);
+            void* ptr = MAP_FAILED;
+            if (state->mode == MmapMode::Anonymous) {
+                ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            } else {
+                ptr = _map_file(bytes);
+            }
+            if (ptr == MAP_FAILED) { _throw(std::runtime_error("Error: mmap failed inside MmapAllocator::allocate for " + state->path)); }
+
+            _advise(ptr, bytes);
+            state->mapped = state->mode != MmapMode::Anonymous;
+            return static_cast<T*>(ptr);
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept {
+            if (ptr == nullptr) { return; }
+            if (state->mode == MmapMode::ReadWrite) { msync(ptr, n * sizeof(T), MS_ASYNC); }
+            munmap(ptr, n * sizeof(T));
+            if (state->mode != MmapMode::Anonymous) { state->mapped = false; }
+        }
+
+        // Flush the pages of a writable mapping to the file.
+        static void flush(const T* ptr, size_t n, bool blocking = true) {
+            msync(const_cast<T*>(ptr), n * sizeof(T), blocking ? MS_SYNC : MS_ASYNC);
+        }
+
+        // Change the access pattern hint, e.g. Sequential while building and Random while querying.
+        void advise(const T* ptr, size_t n, MmapAdvice advice_) const {
+            state->advice = advice_;
+            _advise(const_cast<T*>(ptr), n * sizeof(T));
+        }
+
+        const std::string& path() const { return state->path; }
+        MmapMode mode() const { return state->mode; }
+
+        template <typename U>
+        bool operator==(const MmapAllocator<U>& other) const noexcept {
+            return state == other.state;
+        }
+
+        template <typename U>
+        bool operator!=(const MmapAllocator<U>& other) const noexcept {
+            return state != other.state;
+        }
+
+    private:
+        void* _map_file(size_t bytes) const {
+            const bool writable = state->mode == MmapMode::ReadWrite;
+            const int fd = open(state->path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+            if (fd < 0) { _throw(std::runtime_error("Error: impossible to open " + state->path + " inside MmapAllocator::allocate.")); }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                _throw(std::runtime_error("Error: fstat failed on " + state->path + " inside MmapAllocator::allocate."));
+            }
+            if (static_cast<size_t>(st.st_size) < bytes) {
+                if (!writable || ftruncate(fd, bytes) != 0) {
+                    close(fd);
+                    _throw(std::runtime_error("Error: file " + state->path + " is smaller than the requested mapping."));
+                }
+            }
+
+            void* ptr = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);  // the mapping keeps its own reference to the file
+            return ptr;
+        }
+
+        void _advise(void* ptr, size_t bytes) const {
+            switch (state->advice) {
+            case MmapAdvice::Sequential:
+                madvise(ptr, bytes, MADV_SEQUENTIAL);
+                break;
+            case MmapAdvice::Random:
+                madvise(ptr, bytes, MADV_RANDOM);
+                break;
+            default:
+                madvise(ptr, bytes, MADV_NORMAL);
+            }
+#ifdef MADV_HUGEPAGE
+            // Best effort: honored for anonymous memory and tmpfs/shmem files, ignored elsewhere.
+            if (state->huge_pages) { madvise(ptr, bytes, MADV_HUGEPAGE); }
+#endif
+        }
+
+    private:
+        std::shared_ptr<State> state;
+    };
+
+}  // namespace cav
+
+#endif
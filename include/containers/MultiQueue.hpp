@@ -0,0 +1,167 @@
+/**
+ * Relaxed concurrent priority queue (MultiQueue, Rihani et al. 2015).
+ *
+ * The queue is made of c*p sequential BinaryHeaps, each guarded by its own lock. push inserts into a random heap,
+ * try_pop looks at two random heaps and extracts the better of the two tops. Locks are only try-locked, a busy heap is
+ * simply skipped, so threads never wait on each other.
+ * The extracted element is not always the global minimum: its expected rank is O(c*p), which is usually fine for
+ * best-first search or label-correcting shortest paths.
+ *
+ *      cav::MultiQueuePtr<Node, &Node::dist> Q(nthreads);
+ *      Q.push(root);
+ *      Node* n;
+ *      while (Q.try_pop(n)) { ... Q.push(child); ... }
+ */
+
+#ifndef CAV_MULTIQUEUE_HPP
+#define CAV_MULTIQUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "BinaryHeap.hpp"
+#include "NonCopyable.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Relaxed concurrent min priority queue.
+     *
+     * @tparam T   Type of the elements stored in the queue
+     * @tparam Cmp Binary operator, if scalar: return first - second; (same policy of BinaryHeap)
+     */
+    template <typename T, class Cmp>
+    class MultiQueue : private NonCopyable<MultiQueue<T, Cmp>> {
+        static constexpr size_t ALIGNMENT = 64UL;
+
+        using Heap = BinaryHeap<T, Cmp, NoHeapIdx, NoHeapIdx, NoHeapIdx>;
+
+        struct alignas(ALIGNMENT) SubQueue {
+            std::mutex mtx;
+            std::atomic<size_t> size{0};  // written under mtx, read without it to skip empty heaps
+            Heap heap;
+        };
+
+        struct NoOp {
+            void operator()(const T&) const { }
+        };
+
+    public:
+        /**
+         * @param nthreads number of threads using the queue
+         * @param c        heaps per thread, higher values reduce contention but increase the rank error
+         */
+        explicit MultiQueue(size_t nthreads, size_t c = 2)
+            : nqueues(std::max<size_t>(2, nthreads * c)), queues(std::make_unique<SubQueue[]>(nqueues)) { }
+
+        /**
+         * @brief Insert elem in a random heap.
+         * on_push(elem) is called while the heap is locked (e.g., to timestamp the operation).
+         */
+        template <class OnPush = NoOp>
+        void push(T elem, OnPush&& on_push = OnPush()) {
+            for (;;) {
+                SubQueue& q = queues[_rand() % nqueues];
+                if (!q.mtx.try_lock()) { continue; }
+
+                on_push(elem);
+                q.heap.insert(std::move(elem));
+                q.size.store(q.heap.size(), std::memory_order_relaxed);
+                q.mtx.unlock();
+                return;
+            }
+        }
+
+        /**
+         * @brief Extract the better top of two random heaps.
+         * on_pop(elem) is called while the heap is locked.
+         *
+         * @return false if the queue was empty
+         */
+        template <class OnPop = NoOp>
+        bool try_pop(T& out, OnPop&& on_pop = OnPop()) {
+            for (;;) {
+                const size_t i = _rand() % nqueues;
+                size_t j = _rand() % (nqueues - 1);
+                j += j >= i;
+
+                SubQueue* a = &queues[i];
+                SubQueue* b = &queues[j];
+                if (a->size.load(std::memory_order_relaxed) == 0) { std::swap(a, b); }
+                if (a->size.load(std::memory_order_relaxed) == 0) {
+                    if (empty()) { return false; }
+                    continue;
+                }
+                if (!a->mtx.try_lock()) { continue; }
+
+                if (b->size.load(std::memory_order_relaxed) != 0 && b->mtx.try_lock()) {
+                    if (!b->heap.empty() && (a->heap.empty() || Cmp()(b->heap.spy(0), a->heap.spy(0)) < 0)) { std::swap(a, b); }
+                    b->mtx.unlock();
+                }
+                if (a->heap.empty()) {
+                    a->mtx.unlock();
+                    continue;
+                }
+
+                out = a->heap.get();
+                on_pop(out);
+                a->size.store(a->heap.size(), std::memory_order_relaxed);
+                a->mtx.unlock();
+                return true;
+            }
+        }
+
+        // Snapshot, exact only if no other thread is working on the queue.
+        bool empty() const {
+            for (size_t q = 0; q < nqueues; ++q) {
+                if (queues[q].size.load(std::memory_order_relaxed) != 0) { return false; }
+            }
+            return true;
+        }
+
+        size_t size() const {
+            size_t tot = 0;
+            for (size_t q = 0; q < nqueues; ++q) { tot += queues[q].size.load(std::memory_order_relaxed); }
+            return tot;
+        }
+
+        size_t heap_count() const { return nqueues; }
+
+    private:
+        // xorshift64*, one state per thread
+        static inline uint64_t _rand() {
+            thread_local uint64_t state = (std::hash<std::thread::id>()(std::this_thread::get_id()) | 1ULL) * 0x9E3779B97F4A7C15ULL;
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return (state * 0x2545F4914F6CDD1DULL) >> 32;
+        }
+
+    private:
+        size_t nqueues;
+        std::unique_ptr<SubQueue[]> queues;
+    };
+
+
+    ///////// SPECIALIZATION FOR STRUCTS /////////
+    template <typename N, auto fval>
+    class MultiQueueStruct : public MultiQueue<N, CmpFieldStruct<N, fval>> {
+    public:
+        using MultiQueue<N, CmpFieldStruct<N, fval>>::MultiQueue;
+    };
+
+    ///////// SPECIALIZATION FOR POINTERS TO STRUCT /////////
+    template <typename N, auto fval>
+    class MultiQueuePtr : public MultiQueue<N*, CmpFieldPtr<N, fval>> {
+    public:
+        using MultiQueue<N*, CmpFieldPtr<N, fval>>::MultiQueue;
+    };
+
+}  // namespace cav
+
+#endif
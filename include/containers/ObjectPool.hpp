@@ -0,0 +1,282 @@
+/**
+ * Fixed-size object pool with stable addresses.
+ *
+ * Objects live in 64B aligned slabs that are never moved nor freed until the pool dies, so pointers to them can be
+ * stored around (e.g., in a BinaryHeapPtr) without the reallocation issues of a std::vector:
+ *
+ *      cav::ObjectPool<Node> pool;
+ *      cav::BinaryHeapPtr<Node, &Node::hidx, &Node::dist> Q;
+ *      Q.insert(pool.create(args...));
+ *      ...
+ *      pool.release_all();  // drop every node at once
+ *
+ * Each thread has its own free list and its own slab region (padded to a cache line), so allocate/deallocate do not
+ * synchronize; only grabbing a new slab takes a lock. An object can be freed by a thread different from the one
+ * that allocated it.
+ */
+
+#ifndef CAV_OBJECTPOOL_HPP
+#define CAV_OBJECTPOOL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+#include "NonCopyable.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Small dense ids of the running threads, shared by all the pools.
+     * A thread takes the lowest free id on its first call and gives it back when it exits, so ids stay below the
+     * peak number of live threads even under thread churn. The per-pool caches go with the id: the next thread that
+     * takes it keeps using the free list and the partly used slab left there (the handover is ordered by the lock).
+     */
+    class PoolThreadIds {
+        static constexpr unsigned UNASSIGNED = ~0U;
+        static constexpr unsigned RELEASED = ~0U - 1;  // thread_locals destroyed after the holder use the shared cache
+
+        struct Registry {
+            std::mutex mtx;
+            unsigned next = 0;
+            std::vector<unsigned> free_ids;  // min-heap
+        };
+
+        struct Holder {
+            Holder() { id = _acquire(); }
+            ~Holder() { _release(std::exchange(id, RELEASED)); }
+        };
+
+        static inline thread_local unsigned id = UNASSIGNED;
+
+        // Never destroyed: threads can exit after the static destructors have run.
+        static Registry& _registry() {
+            static auto* reg = new Registry();
+            return *reg;
+        }
+
+        static unsigned _acquire() {
+            Registry& reg = _registry();
+            std::lock_guard<std::mutex> lock(reg.mtx);
+            if (reg.free_ids.empty()) { return reg.next++; }
+            std::pop_heap(reg.free_ids.begin(), reg.free_ids.end(), std::greater<>());
+            const unsigned tid = reg.free_ids.back();
+            reg.free_ids.pop_back();
+            return tid;
+        }
+
+        static void _release(unsigned tid) {
+            Registry& reg = _registry();
+            std::lock_guard<std::mutex> lock(reg.mtx);
+            reg.free_ids.push_back(tid);
+            std::push_heap(reg.free_ids.begin(), reg.free_ids.end(), std::greater<>());
+        }
+
+    public:
+        static unsigned get() {
+            if (id == UNASSIGNED) { thread_local Holder holder; }
+            return id;
+        }
+    };
+
+    inline unsigned pool_thread_id() { return PoolThreadIds::get(); }
+
+    template <typename T>
+    class ObjectPool : private NonCopyable<ObjectPool<T>> {
+        static constexpr size_t ALIGNMENT = 64UL;
+        static constexpr size_t SLAB_BYTES = 1UL << 16;
+
+        struct FreeNode {
+            FreeNode* next;
+        };
+
+        static constexpr size_t SLOT_ALIGN = std::max(alignof(T), alignof(FreeNode));
+        static constexpr size_t SLOT_SIZE = (std::max(sizeof(T), sizeof(FreeNode)) + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+        static constexpr size_t SLAB_SLOTS = std::max(SLAB_BYTES / SLOT_SIZE, size_t{1});
+
+        struct alignas(ALIGNMENT) ThreadCache {
+            FreeNode* head = nullptr;
+            std::byte* bump = nullptr;
+            std::byte* bump_end = nullptr;
+        };
+
+    public:
+        // Threads with id >= MAX_THREADS (more than MAX_THREADS alive at once) share a single cache protected by the
+        // pool lock.
+        static constexpr unsigned MAX_THREADS = 128U;
+
+        ObjectPool() : caches(std::make_unique<ThreadCache[]>(MAX_THREADS + 1)), next_slab(0) { }
+
+        ~ObjectPool() {
+            for (std::byte* slab : slabs) { slab_alloc.deallocate(slab, SLAB_SLOTS * SLOT_SIZE); }
+        }
+
+        // Pool used by PoolAllocator<T>.
+        static ObjectPool& instance() {
+            static ObjectPool pool;
+            return pool;
+        }
+
+        /**
+         * @brief Raw storage for one T.
+         */
+        inline T* allocate() {
+            const unsigned tid = pool_thread_id();
+            if (tid >= MAX_THREADS) {
+                std::lock_guard<std::mutex> lock(mtx);
+                return _allocate(caches[MAX_THREADS]);
+            }
+            return _allocate(caches[tid]);
+        }
+
+        inline void deallocate(T* ptr) {
+            const unsigned tid = pool_thread_id();
+            if (tid >= MAX_THREADS) {
+                std::lock_guard<std::mutex> lock(mtx);
+                return _deallocate(caches[MAX_THREADS], ptr);
+            }
+            _deallocate(caches[tid], ptr);
+        }
+
+        template <typename... Args>
+        inline T* create(Args&&... args) {
+            return new (allocate()) T(std::forward<Args>(args)...);
+        }
+
+        inline void destroy(T* ptr) {
+            ptr->~T();
+            deallocate(ptr);
+        }
+
+        /**
+         * @brief Give back every object at once, keeping the slabs for the next allocations.
+         * Destructors are not called, and no other thread must be using the pool meanwhile.
+         */
+        void release_all() {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (unsigned t = 0; t <= MAX_THREADS; ++t) { caches[t] = ThreadCache(); }
+            next_slab = 0;
+        }
+
+        inline size_t slab_count() const { return slabs.size(); }
+
+    private:
+        inline T* _allocate(ThreadCache& c) {
+            if (c.head != nullptr) {
+                FreeNode* node = c.head;
+                c.head = node->next;
+                return reinterpret_cast<T*>(node);
+            }
+            if (c.bump == c.bump_end) { _grab_slab(c); }
+            T* ptr = reinterpret_cast<T*>(c.bump);
+            c.bump += SLOT_SIZE;
+            return ptr;
+        }
+
+        inline void _deallocate(ThreadCache& c, T* ptr) {
+            auto* node = reinterpret_cast<FreeNode*>(ptr);
+            node->next = c.head;
+            c.head = node;
+        }
+
+        void _grab_slab(ThreadCache& c) {
+            std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
+            if (&c != &caches[MAX_THREADS]) { lock.lock(); }  // the shared cache already holds it
+
+            if (next_slab == slabs.size()) { slabs.emplace_back(slab_alloc.allocate(SLAB_SLOTS * SLOT_SIZE)); }
+            c.bump = slabs[next_slab++];
+            c.bump_end = c.bump + SLAB_SLOTS * SLOT_SIZE;
+        }
+
+    private:
+        std::unique_ptr<ThreadCache[]> caches;
+        std::vector<std::byte*> slabs;
+        size_t next_slab;
+        std::mutex mtx;
+        AlignedAllocator<std::byte, ALIGNMENT> slab_alloc;
+    };
+
+
+    // Largest block served from a pool by PoolAllocator.
+    static constexpr size_t POOL_ALLOCATOR_MAX_BYTES = 4096UL;
+
+    /**
+     * @brief STL allocator backed by pools: single objects come from ObjectPool<T>::instance() (node based
+     * containers), arrays of n elements from the pool of blocks of next_pow_2(n) elements, as long as a block takes
+     * at most POOL_ALLOCATOR_MAX_BYTES (e.g. the power of two buffers of a CircularVector). Bigger requests fall back
+     * to aligned new.
+     * NOTE: pooled arrays are aligned to alignof(T) only.
+     *
+     * @tparam T
+     */
+    template <typename T>
+    class PoolAllocator {
+        template <size_t N>
+        struct Block {
+            alignas(T) std::byte bytes[N * sizeof(T)];
+        };
+
+        static constexpr size_t _max_pooled() {
+            size_t n = 1;
+            while (2 * n * sizeof(T) <= POOL_ALLOCATOR_MAX_BYTES) { n *= 2; }
+            return n;
+        }
+
+        static constexpr size_t MAX_POOLED = _max_pooled();
+
+        // Pool of the smallest size class >= n (size classes N = 1, 2, 4, ..., MAX_POOLED).
+        template <size_t N = 1, typename Func>
+        static inline auto _with_pool(size_t n, Func&& f) {
+            if constexpr (N < MAX_POOLED) {
+                if (n > N) { return _with_pool<2 * N>(n, std::forward<Func>(f)); }
+            }
+            if constexpr (N == 1) {
+                return f(ObjectPool<T>::instance());
+            } else {
+                return f(ObjectPool<Block<N>>::instance());
+            }
+        }
+
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        PoolAllocator() noexcept = default;
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+        inline T* allocate(size_t n) {
+            if (n > MAX_POOLED) { return AlignedAllocator<T>().allocate(n); }
+            return _with_pool(n, [](auto& pool) { return reinterpret_cast<T*>(pool.allocate()); });
+        }
+
+        inline void deallocate(T* ptr, size_t n) noexcept {
+            if (n > MAX_POOLED) { return AlignedAllocator<T>().deallocate(ptr, n); }
+            _with_pool(n, [ptr](auto& pool) {
+                using Slot = std::remove_pointer_t<decltype(pool.allocate())>;
+                pool.deallocate(reinterpret_cast<Slot*>(ptr));
+            });
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>&) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>&) const noexcept {
+            return false;
+        }
+    };
+
+}  // namespace cav
+
+#endif
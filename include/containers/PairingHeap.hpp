@@ -0,0 +1,251 @@
+#ifndef CAV_PAIRINGHEAP_HPP
+#define CAV_PAIRINGHEAP_HPP
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BinaryHeap.hpp"
+#include "ObjectPool.hpp"
+
+namespace cav {
+    /**
+     * @brief Pairing Heap sorting the minimum first. Unlike BinaryHeap, two heaps can be melded in O(1), and insert is
+     * O(1) while get and decrease-key are amortized O(log n).
+     * Elements live in nodes allocated through Alloc (pooled by default); insert returns the handle that identifies the
+     * element for update/remove, playing the role of the heap index of BinaryHeap.
+     *
+     * @tparam T     Type of the elements stored in the heap
+     * @tparam Cmp   Binary operator, if scalar: return first - second;
+     * @tparam Updt  Update the value of an element and return a value equal to Cmp()(old_element, new_element)
+     * @tparam Alloc Allocator of T, rebound to the internal node type
+     */
+    template <typename T, class Cmp, class Updt, class Alloc = PoolAllocator<T>>
+    class PairingHeap {
+
+        struct Node {
+            T elem;
+            Node* child;
+            Node* next;
+            Node* prev;  // parent if leftmost child, left sibling otherwise
+        };
+
+        using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+        using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    public:
+        using handle = Node*;
+
+        explicit PairingHeap(const Alloc& alloc = Alloc()) : node_alloc(alloc), root(nullptr), hsize(0) { }
+
+        PairingHeap(const PairingHeap&) = delete;
+        PairingHeap& operator=(const PairingHeap&) = delete;
+
+        PairingHeap(PairingHeap&& other) noexcept
+            : node_alloc(std::move(other.node_alloc)), root(std::exchange(other.root, nullptr)), hsize(std::exchange(other.hsize, 0)) { }
+
+        PairingHeap& operator=(PairingHeap&& other) noexcept {
+            reset();
+            node_alloc = std::move(other.node_alloc);
+            root = std::exchange(other.root, nullptr);
+            hsize = std::exchange(other.hsize, 0);
+            return *this;
+        }
+
+        ~PairingHeap() { reset(); }
+
+        void reset() {
+            if (root == nullptr) { return; }
+
+            std::vector<Node*> stack = {root};
+            while (!stack.empty()) {
+                Node* n = stack.back();
+                stack.pop_back();
+                if (n->child != nullptr) { stack.emplace_back(n->child); }
+                if (n->next != nullptr) { stack.emplace_back(n->next); }
+                _destroy(n);
+            }
+            root = nullptr;
+            hsize = 0;
+        }
+
+        bool empty() const { return root == nullptr; }
+
+        auto size() const { return hsize; }
+
+        /**
+         * @brief Replace the content of the heap with the elements in [first, last), in O(n) (multi-pass pairing).
+         */
+        template <typename It>
+        void make_heap(It first, It last) {
+            reset();
+
+            std::vector<Node*> roots;
+            for (; first != last; ++first) { roots.emplace_back(_create(*first)); }
+            hsize = roots.size();
+
+            for (size_t nroots = roots.size(); nroots > 1; nroots = (nroots + 1) / 2) {
+                for (size_t i = 0; i < nroots / 2; ++i) { roots[i] = _link(roots[2 * i], roots[2 * i + 1]); }
+                if (nroots % 2) { roots[nroots / 2] = roots[nroots - 1]; }
+            }
+            root = roots.empty() ? nullptr : roots[0];
+        }
+
+        handle insert(T elem) {
+            Node* n = _create(std::move(elem));
+            root = root == nullptr ? n : _link(root, n);
+            ++hsize;
+            return n;
+        }
+
+        T& spy() {
+            assert(root != nullptr);
+            return root->elem;
+        }
+
+        T& spy(handle h) { return h->elem; }
+
+        T get() {
+            assert(root != nullptr);
+
+            Node* old_root = root;
+            root = _merge_pairs(root->child);
+            --hsize;
+
+            auto elem = std::move(old_root->elem);
+            _destroy(old_root);
+            return elem;
+        }
+
+        /**
+         * @brief Move all the elements of other into this heap in O(1); other is left empty.
+         * The handles of other stay valid and now refer to this heap.
+         */
+        void meld(PairingHeap& other) {
+            assert(node_alloc == other.node_alloc);
+
+            if (other.root != nullptr) { root = root == nullptr ? other.root : _link(root, other.root); }
+            hsize += other.hsize;
+            other.root = nullptr;
+            other.hsize = 0;
+        }
+
+        void remove(handle h) {
+            if (h == root) {
+                get();
+                return;
+            }
+
+            _cut(h);
+            if (Node* rest = _merge_pairs(h->child); rest != nullptr) { root = _link(root, rest); }
+            --hsize;
+            _destroy(h);
+        }
+
+        template <typename... Args>
+        void update(handle h, Args&&... args) {
+            const auto case3 = Updt()(h->elem, std::forward<Args>(args)...);
+
+            if (case3 > 0) {  // decrease-key: the subtree of h stays heap ordered
+                if (h == root) { return; }
+                _cut(h);
+                root = _link(root, h);
+
+            } else if (case3 < 0) {  // increase-key: children of h may now be smaller
+                Node* rest = _merge_pairs(h->child);
+                h->child = nullptr;
+                if (h == root) {
+                    root = rest;
+                } else {
+                    _cut(h);
+                    if (rest != nullptr) { root = _link(root, rest); }
+                }
+                root = root == nullptr ? h : _link(root, h);
+            }
+        }
+
+    private:
+        template <typename U>
+        inline Node* _create(U&& elem) {
+            Node* n = NodeTraits::allocate(node_alloc, 1);
+            NodeTraits::construct(node_alloc, n, Node{std::forward<U>(elem), nullptr, nullptr, nullptr});
+            return n;
+        }
+
+        inline void _destroy(Node* n) {
+            NodeTraits::destroy(node_alloc, n);
+            NodeTraits::deallocate(node_alloc, n, 1);
+        }
+
+        // Link two roots, the loser becomes the leftmost child of the winner.
+        inline Node* _link(Node* a, Node* b) {
+            if (Cmp()(b->elem, a->elem) < 0) { std::swap(a, b); }
+
+            b->next = a->child;
+            if (a->child != nullptr) { a->child->prev = b; }
+            b->prev = a;
+            a->child = b;
+            a->next = a->prev = nullptr;
+            return a;
+        }
+
+        // Detach the subtree rooted in n (n != root).
+        inline void _cut(Node* n) {
+            if (n->prev->child == n) {
+                n->prev->child = n->next;
+            } else {
+                n->prev->next = n->next;
+            }
+            if (n->next != nullptr) { n->next->prev = n->prev; }
+            n->next = n->prev = nullptr;
+        }
+
+        // Standard two-pass pairing of a sibling list: left to right in pairs, then right to left into a single root.
+        Node* _merge_pairs(Node* first) {
+            if (first == nullptr) { return nullptr; }
+
+            Node* paired = nullptr;  // stack of the pairs, linked through next
+            while (first != nullptr) {
+                Node* a = first;
+                Node* b = a->next;
+                if (b == nullptr) {
+                    a->next = paired;
+                    paired = a;
+                    break;
+                }
+                first = b->next;
+                Node* r = _link(a, b);
+                r->next = paired;
+                paired = r;
+            }
+
+            Node* res = paired;
+            paired = paired->next;
+            res->next = res->prev = nullptr;
+            while (paired != nullptr) {
+                Node* n = paired;
+                paired = paired->next;
+                res = _link(res, n);
+            }
+            return res;
+        }
+
+    private:
+        NodeAlloc node_alloc;
+        Node* root;
+        size_t hsize;
+    };
+
+
+    ///////// SPECIALIZATION FOR STRUCTS /////////
+    template <typename N, auto fval, class Alloc = PoolAllocator<N>>
+    class PairingHeapStruct : public PairingHeap<N, CmpFieldStruct<N, fval>, UpdtFieldStruct<N, fval>, Alloc> { };
+
+    ///////// SPECIALIZATION FOR POINTERS TO STRUCT /////////
+    template <typename N, auto fval, class Alloc = PoolAllocator<N*>>
+    class PairingHeapPtr : public PairingHeap<N*, CmpFieldPtr<N, fval>, UpdtFieldPtr<N, fval>, Alloc> { };
+
+}  // namespace cav
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef CAV_SOAVECTOR_HPP
+#define CAV_SOAVECTOR_HPP
+
+#include <cassert>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "AlignedAllocator.hpp"
+#include "VectorView.hpp"
+#include "functors.hpp"
+
+namespace cav {
+
+    /**
+     * @brief Handle to a row of a SoAVector. Copying/assigning a SoARowRef rebinds the handle (pointer-like semantics),
+     * use store() and load() to write/read the whole record.
+     *
+     * @tparam SoA the SoAVector type
+     */
+    template <typename SoA>
+    class SoARowRef {
+    public:
+        SoARowRef(SoA* soa_, size_t idx_) : soa(soa_), idx(idx_) { }
+
+        template <auto field>
+        inline auto& get() const {
+            return soa->template column<field>()[idx];
+        }
+
+        inline size_t index() const { return idx; }
+
+        inline auto load() const { return soa->load(idx); }
+        inline void store(const typename SoA::struct_type& s) const { soa->store(idx, s); }
+
+    private:
+        SoA* soa;
+        size_t idx;
+    };
+
+    /**
+     * @brief Structure of arrays: each listed member of Struct is stored in its own 64B aligned array, so loops that
+     * touch a single field (e.g. the distances in a scan) read contiguous memory and vectorize.
+     *
+     *      struct Node { int edge, hidx; double dist; };
+     *      cav::SoAVector<Node, &Node::edge, &Node::hidx, &Node::dist> nodes(n);
+     *      nodes[i].get<&Node::dist>() = 0.0;
+     *      double* dist = nodes.data<&Node::dist>();
+     *
+     * Rows are accessed through SoARowRef, a (container, index) handle that specializes get_field_ref/get_field_type, so
+     * the BinaryHeap field policies work on it (see BinaryHeapProxy).
+     *
+     * @tparam Struct the record type whose members are split
+     * @tparam fields pointers to the members of Struct to store
+     */
+    template <typename Struct, auto... fields>
+    class SoAVector {
+        static_assert(sizeof...(fields) > 0, "At least one field is needed.");
+
+        template <auto field>
+        using field_t = typename get_field_type<Struct, field>::type;
+
+        template <typename U>
+        using column_t = std::vector<U, AlignedAllocator<U, 64UL>>;
+
+        template <auto a, auto b>
+        static constexpr bool same_field() {
+            if constexpr (std::is_same_v<decltype(a), decltype(b)>) {
+                return a == b;
+            } else {
+                return false;
+            }
+        }
+
+        template <auto field>
+        static constexpr size_t index_of() {
+            size_t i = 0, res = sizeof...(fields);
+            ((same_field<field, fields>() ? (res = i++) : i++), ...);
+            return res;
+        }
+
+    public:
+        using struct_type = Struct;
+        using RowRef = SoARowRef<SoAVector>;
+
+        SoAVector() = default;
+        explicit SoAVector(size_t n) { resize(n); }
+        SoAVector(size_t n, const Struct& s) { assign(n, s); }
+
+        inline size_t size() const { return std::get<0>(columns).size(); }
+        inline bool empty() const { return size() == 0; }
+
+        inline void resize(size_t n) {
+            std::apply([n](auto&... col) { (col.resize(n), ...); }, columns);
+        }
+
+        inline void reserve(size_t n) {
+            std::apply([n](auto&... col) { (col.reserve(n), ...); }, columns);
+        }
+
+        inline void clear() {
+            std::apply([](auto&... col) { (col.clear(), ...); }, columns);
+        }
+
+        inline void assign(size_t n, const Struct& s) { (column<fields>().assign(n, s.*fields), ...); }
+
+        inline void push_back(const Struct& s) { (column<fields>().push_back(s.*fields), ...); }
+
+        inline Struct load(size_t i) const {
+            Struct s;
+            ((s.*fields = column<fields>()[i]), ...);
+            return s;
+        }
+
+        inline void store(size_t i, const Struct& s) { ((column<fields>()[i] = s.*fields), ...); }
+
+        inline RowRef operator[](size_t i) {
+            assert(i < size());
+            return RowRef(this, i);
+        }
+
+        // The whole array of a single field.
+        template <auto field>
+        inline auto& column() {
+            static_assert(index_of<field>() < sizeof...(fields), "Field not stored in this SoAVector.");
+            return std::get<index_of<field>()>(columns);
+        }
+
+        template <auto field>
+        inline const auto& column() const {
+            static_assert(index_of<field>() < sizeof...(fields), "Field not stored in this SoAVector.");
+            return std::get<index_of<field>()>(columns);
+        }
+
+        template <auto field>
+        inline auto* data() {
+            return column<field>().data();
+        }
+
+        template <auto field>
+        inline const auto* data() const {
+            return column<field>().data();
+        }
+
+        template <auto field>
+        inline auto view() {
+            return VectorView<field_t<field>*>(data<field>(), data<field>() + size());
+        }
+
+    private:
+        std::tuple<column_t<field_t<fields>>...> columns;
+    };
+
+
+    ///////// FIELD ACCESS THROUGH ROW REFERENCES /////////
+    template <typename SoA, auto field>
+    struct get_field_type<SoARowRef<SoA>, field> {
+        typedef typename get_field_type<typename SoA::struct_type, field>::type type;
+    };
+
+    template <typename SoA, auto field>
+    struct get_field_ref<SoARowRef<SoA>, field> {
+        auto& operator()(const SoARowRef<SoA>& r) const { return r.template get<field>(); }
+    };
+
+}  // namespace cav
+
+#endif
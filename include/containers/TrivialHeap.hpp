@@ -1,14 +1,33 @@
 #ifndef CAV_TRIVIALHEAP_HPP
 #define CAV_TRIVIALHEAP_HPP
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cinttypes>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 
 namespace cav {
+    /**
+     * @brief Fixed size sorted buffer, the "best" element (the minimum w.r.t. Comp) is always in back().
+     * Elements are kept so that Comp(buf[i], buf[j]) is false for i < j, hence buf[0] is the worst one.
+     *
+     * Used as a k-best collector: insert_bounded/insert_many keep only the Nm best elements seen so far, rejecting
+     * with a single comparison against the current worst once the buffer is full.
+     *
+     * @tparam T    type of the elements
+     * @tparam Nm   maximum number of elements
+     * @tparam Comp strict ordering, Comp()(a, b) is true if a is better than b
+     */
     template <typename T, std::size_t Nm, typename Comp>
     class TrivialHeap {
     public:
         inline auto size() const { return sz; }
+        inline bool empty() const { return sz == 0U; }
+        inline bool full() const { return sz == Nm; }
+        static constexpr std::size_t capacity() { return Nm; }
 
         inline void pop_back() {
             assert(sz > 0);
@@ -25,6 +44,12 @@ namespace cav {
             return buf[sz - 1];
         }
 
+        // Worst element kept, the threshold a candidate has to beat when the heap is full
+        inline const T& front() const {
+            assert(sz > 0);
+            return buf[0];
+        }
+
         inline auto begin() const { return std::addressof(buf[0]); }
         inline auto begin() { return std::addressof(buf[0]); }
         inline auto end() const { return std::addressof(buf[sz]); }
@@ -32,21 +57,76 @@ namespace cav {
 
         inline void insert(T elem) {
             assert(sz < Nm);
-            auto* ptr = end();
-            while (ptr != begin() && Comp()(*(ptr - 1), elem)) {
-                *(ptr) = *(ptr - 1);
-                --ptr;
-            }
-            *ptr = elem;
+            const uint32_t p = _insertion_point(elem);
+            std::move_backward(begin() + p, end(), end() + 1);
+            buf[p] = elem;
             ++sz;
         }
 
+        /**
+         * @brief Top-k insertion: when full, elem replaces the worst element if it is better, otherwise it is dropped.
+         *
+         * @return true if elem has been inserted
+         */
+        inline bool insert_bounded(T elem) {
+            if (sz < Nm) {
+                insert(elem);
+                return true;
+            }
+            if (!Comp()(elem, buf[0])) { return false; }
+
+            // Elements in [1, p) are worse than elem, they slide one position towards the (dropped) worst one.
+            const uint32_t p = _insertion_point(elem);
+            std::move(begin() + 1, begin() + p, begin());
+            buf[p - 1] = elem;
+            return true;
+        }
+
+        /**
+         * @brief Top-k insertion of a batch of candidates. Once the heap is full, candidates not better than the current
+         * worst one are rejected by a single comparison.
+         *
+         * @return number of inserted elements
+         */
+        template <typename InputIt>
+        inline uint32_t insert_many(InputIt first, InputIt last) {
+            uint32_t inserted = 0U;
+            for (; first != last && sz < Nm; ++first, ++inserted) { insert(*first); }
+            for (; first != last; ++first) {
+                if (Comp()(*first, buf[0])) { inserted += insert_bounded(*first); }
+            }
+            return inserted;
+        }
+
+        template <typename Range>
+        inline uint32_t insert_many(const Range& range) {
+            return insert_many(std::begin(range), std::end(range));
+        }
+
         inline void clear() { sz = 0U; }
 
+    private:
+        /**
+         * @brief Number of elements not worse than elem, i.e. its sorted position (placed after the equal ones).
+         * For arithmetic types this is a branchless count over the whole buffer that the compiler vectorizes,
+         * instead of the element-by-element shift with an early exit.
+         */
+        inline uint32_t _insertion_point(const T& elem) const {
+            if constexpr (std::is_arithmetic_v<T>) {
+                uint32_t p = 0U;
+                for (uint32_t i = 0U; i < sz; ++i) { p += static_cast<uint32_t>(!Comp()(buf[i], elem)); }
+                return p;
+            } else {
+                uint32_t p = sz;
+                while (p > 0U && Comp()(buf[p - 1], elem)) { --p; }
+                return p;
+            }
+        }
+
     private:
         T buf[Nm];
         uint32_t sz = 0U;
     };
 }  // namespace cav
 
-#endif
\ No newline at end of file
+#endif
@@ -9,11 +9,19 @@ namespace cav {
         constexpr T&& operator()(T&& t) const noexcept { return std::forward<T>(t); }
     };
 
+    // Same for lvalues, default op of ContainerJitMap.
+    template <typename T>
+    struct identity_functor {
+        constexpr const T& operator()(const T& t) const noexcept { return t; }
+    };
+
     template <typename Struct, typename fieldType, fieldType Struct::*field>
     struct base_get_field_ref {
         auto& operator()(Struct& t) const { return t.*field; }
+        const auto& operator()(const Struct& t) const { return t.*field; }
     };
 
+    // Can be specialized by proxy types (e.g. SoAVector rows) that expose the fields of Struct without being one.
     template <typename Struct, auto field>
     struct get_field_type {
         typedef typename std::decay<decltype(std::declval<Struct>().*field)>::type type;
@@ -4,78 +4,105 @@
 
 #include <algorithm>
 #include <cassert>
-#include <fstream>
-#include <sstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "NumberParsing.hpp"
+#include "ParallelParse.hpp"
+#include "StringUtils.hpp"
+#include "TspLibLexer.hpp"
+
+/**
+ * @brief SCP instance in column-major (CSC) form: rows covered by column j are matval[matbeg[j]..matbeg[j+1]).
+ * All the vectors use (a rebind of) Alloc, e.g. a cav::ArenaAllocator to drop the whole instance with an arena reset.
+ */
+template <typename Alloc = std::allocator<int>>
+struct BasicInstanceData {
+    template <typename U>
+    using vector = std::vector<U, typename std::allocator_traits<Alloc>::template rebind_alloc<U>>;
+
+    explicit BasicInstanceData(const Alloc& allocator = Alloc()) : costs(allocator), solcosts(allocator), matbeg(allocator), matval(allocator), warmstart(allocator) { }
 
-
-struct InstanceData {
     int nrows{};
-    std::vector<double> costs{};
-    std::vector<double> solcosts{};
-    std::vector<int> matbeg{};
-    std::vector<int> matval{};
-    std::vector<int> warmstart;
+    vector<double> costs;
+    vector<double> solcosts;
+    vector<int> matbeg;
+    vector<int> matval;
+    vector<int> warmstart;
 };
 
+using InstanceData = BasicInstanceData<>;
+
 
 
+// Tokens of s separated by (runs of) delim; whitespace delimiters use the SIMD SPACES scanner.
 static inline std::vector<std::string> split(std::string& s, char delim) {
-    trim(s);
-    std::vector<std::string> elems;
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, delim)) { elems.push_back(item); }
-    return elems;
+    std::vector<std::string_view> views;
+    if (cav::SPACES_SET(delim)) {
+        cav::split_views(s, views);
+    } else {
+        cav::split_views(cav::trim(std::string_view(s)), cav::CharSet(delim), views);
+    }
+    return std::vector<std::string>(views.begin(), views.end());
 }
 
-InstanceData parse_scp_instance(const std::string& path) {
+// Next count numbers of text into out, text is moved past them.
+template <typename T>
+static inline void read_numbers(std::string_view& text, T* out, size_t count, const std::string& path) {
+    cav::ParseNumbersResult res;
+    if constexpr (std::is_floating_point_v<T>) {
+        res = cav::parse_floats(text, out, count);
+    } else {
+        res = cav::parse_uints(text, out, count);
+    }
+    if (res.count != count) { throw std::runtime_error("Error: malformed or truncated instance file " + path); }
+    text.remove_prefix(res.ptr - text.data());
+}
+
+template <typename Alloc = std::allocator<int>>
+BasicInstanceData<Alloc> parse_scp_instance(const std::string& path, const Alloc& allocator = Alloc()) {
+    using IdxAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned long>;
+    using ColsAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::vector<unsigned long, IdxAlloc>>;
 
-    auto in = std::ifstream(path);
+    const auto file = cav::MappedFile(path);
+    auto text = file.view();
+    auto inst = BasicInstanceData<Alloc>(allocator);
 
     // rows columns
-    auto line = std::string();
-    std::getline(in, line);
-    auto tokens = split(line, ' ');
-    const auto nrows = std::stoul(tokens[0]);
-    const auto ncols = std::stoul(tokens[1]);
-
-    // cost for each column
-    auto costs = std::vector<double>(ncols);
-    auto j = 0UL;
-    while (j < costs.size()) {
-        std::getline(in, line);
-        tokens = split(line, ' ');
-        for (const auto& token : tokens) {
-            assert(j < costs.size());
-            costs[j] = std::stof(token);
-            j++;
-        }
-    }
-    assert(j == costs.size());
+    unsigned long header[2];
+    read_numbers(text, header, 2, path);
+    const auto nrows = header[0];
+    const auto ncols = header[1];
+
+    // cost for each column (read as float, like the parallel parsers)
+    auto& costs = inst.costs;
+    auto fcosts = std::vector<float>(ncols);
+    read_numbers(text, fcosts.data(), ncols, path);
+    costs.assign(fcosts.begin(), fcosts.end());
 
     // for each row, the number of columns which cover row i followed by a list of the columns which cover row i
-    auto cols = std::vector<std::vector<unsigned long>>(ncols);
+    auto cols = std::vector<std::vector<unsigned long, IdxAlloc>, ColsAlloc>(ncols, std::vector<unsigned long, IdxAlloc>(IdxAlloc(allocator)), ColsAlloc(allocator));
+    auto icols_idx = std::vector<unsigned long>();
     for (auto i = 0UL; i < nrows; i++) {
-        std::getline(in, line);
-        const auto icols = std::stoul(line);
-
-        auto n = 0UL;
-        while (n < icols) {
-            std::getline(in, line);
-            tokens = split(line, ' ');
-            for (const auto& token : tokens) {
-                const auto cidx = std::stoul(token) - 1;
-                assert(cidx < cols.size());
-                cols[cidx].emplace_back(i);
-                n++;
-            }
+        unsigned long icols;
+        read_numbers(text, &icols, 1, path);
+        icols_idx.resize(icols);
+        read_numbers(text, icols_idx.data(), icols, path);
+
+        for (const auto c : icols_idx) {
+            const auto cidx = c - 1;
+            assert(cidx < cols.size());
+            cols[cidx].emplace_back(i);
         }
-
-        assert(n == icols);
     }
 
-    auto matbeg = std::vector<unsigned>();
-    auto matval = std::vector<unsigned>();
+    auto& matbeg = inst.matbeg;
+    auto& matval = inst.matval;
 
     for (const auto& col : cols) {
         matbeg.emplace_back(matval.size());
@@ -84,42 +111,140 @@ InstanceData parse_scp_instance(const std::string& path) {
 
     matbeg.emplace_back(matval.size());
 
-    return {static_cast<unsigned>(nrows), costs, costs, matbeg, matval, {}};
+    inst.nrows = static_cast<int>(nrows);
+    inst.solcosts = costs;
+    return inst;
 }
 
-InstanceData parse_rail_instance(const std::string& path) {
+template <typename Alloc = std::allocator<int>>
+BasicInstanceData<Alloc> parse_rail_instance(const std::string& path, const Alloc& allocator = Alloc()) {
 
-    auto in = std::ifstream(path);
+    const auto file = cav::MappedFile(path);
+    auto text = file.view();
+    auto inst = BasicInstanceData<Alloc>(allocator);
 
     // rows columns
-    auto line = std::string();
-    std::getline(in, line);
-    auto tokens = split(line, ' ');
-    const auto nrows = std::stoul(tokens[0]);
-    const auto ncols = std::stoul(tokens[1]);
-
-    auto costs = std::vector<double>(ncols);
-    auto matbeg = std::vector<unsigned>();
-    auto matval = std::vector<unsigned>();
-
+    unsigned long header[2];
+    read_numbers(text, header, 2, path);
+    const auto nrows = header[0];
+    const auto ncols = header[1];
+
+    auto& costs = inst.costs;
+    auto& matbeg = inst.matbeg;
+    auto& matval = inst.matval;
+    costs.resize(ncols);
+
+    // one "cost jrows rows..." record per column
+    auto jrows_idx = std::vector<unsigned long>();
     for (auto j = 0UL; j < ncols; j++) {
+        float cost;
+        unsigned long jrows;
+        read_numbers(text, &cost, 1, path);
+        read_numbers(text, &jrows, 1, path);
+        costs[j] = cost;
 
-        std::getline(in, line);
-        tokens = split(line, ' ');
-        costs[j] = std::stof(tokens[0]);
-        const auto jrows = std::stoul(tokens[1]);
+        jrows_idx.resize(jrows);
+        read_numbers(text, jrows_idx.data(), jrows, path);
 
         matbeg.emplace_back(matval.size());
-
-        for (auto n = 0UL; n < jrows; n++) {
-            const auto i = std::stoul(tokens[n + 2]) - 1;
-            matval.emplace_back(i);
-        }
+        for (const auto i : jrows_idx) { matval.emplace_back(i - 1); }
     }
 
     matbeg.emplace_back(matval.size());
 
-    return {static_cast<unsigned>(nrows), costs, costs, matbeg, matval, {}};
+    inst.nrows = static_cast<int>(nrows);
+    inst.solcosts = costs;
+    return inst;
+}
+
+/**
+ * @brief Same result of parse_rail_instance, with the column lines split in chunks parsed by nthreads threads.
+ * Every chunk fills its own costs/counts/rows arrays, the final matbeg/matval positions come from a prefix sum over the
+ * chunks, so the copies into inst are done in parallel too.
+ */
+template <typename Alloc = std::allocator<int>>
+BasicInstanceData<Alloc> parse_rail_instance_parallel(const std::string& path, unsigned nthreads, const Alloc& allocator = Alloc()) {
+    struct ChunkData {
+        std::vector<float> costs;
+        std::vector<int> counts;
+        std::vector<int> rows;
+        bool malformed = false;
+    };
+
+    const auto file = cav::MappedFile(path);
+    auto lex = cav::TspLibLexer(file.view());
+    auto inst = BasicInstanceData<Alloc>(allocator);
+
+    // rows columns
+    const auto nrows = lex.value<unsigned long>();
+    const auto ncols = lex.value<unsigned long>();
+    lex.skip_line();
+
+    const auto body = std::string_view(lex.position(), lex.input_end() - lex.position());
+    const auto chunks = cav::split_at_newlines(body, nthreads * cav::PARSE_CHUNKS_PER_THREAD);
+    auto data = std::vector<ChunkData>(chunks.size());
+
+    cav::parallel_for_chunks(chunks.size(), nthreads, [&](size_t c) {
+        auto text = chunks[c];
+        ChunkData& d = data[c];
+        auto jrows_idx = std::vector<unsigned>();
+        float cost;
+        unsigned jrows;
+        while (!(text = cav::ltrim(text)).empty()) {
+            const auto cost_res = cav::parse_floats(text, &cost, 1);
+            const auto jrows_res = cav::parse_uints(text.substr(cost_res.ptr - text.data()), &jrows, 1);
+            if (cost_res.count != 1 || jrows_res.count != 1) {
+                d.malformed = true;
+                return;
+            }
+            text.remove_prefix(jrows_res.ptr - text.data());
+
+            jrows_idx.resize(jrows);
+            const auto rows_res = cav::parse_uints(text, jrows_idx.data(), jrows);
+            if (rows_res.count != jrows) {
+                d.malformed = true;
+                return;
+            }
+            text.remove_prefix(rows_res.ptr - text.data());
+
+            for (const auto i : jrows_idx) { d.rows.emplace_back(static_cast<int>(i) - 1); }
+            d.costs.emplace_back(cost);
+            d.counts.emplace_back(static_cast<int>(jrows));
+        }
+    });
+
+    // prefix sums: first column and first nonzero of each chunk
+    auto col_beg = std::vector<size_t>(chunks.size() + 1, 0);
+    auto val_beg = std::vector<size_t>(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (data[c].malformed) { throw std::runtime_error("Error: malformed column line in " + path); }
+        col_beg[c + 1] = col_beg[c] + data[c].costs.size();
+        val_beg[c + 1] = val_beg[c] + data[c].rows.size();
+    }
+    if (col_beg.back() != ncols) { throw std::runtime_error("Error: wrong number of columns in " + path); }
+
+    auto& costs = inst.costs;
+    auto& matbeg = inst.matbeg;
+    auto& matval = inst.matval;
+    costs.resize(ncols);
+    matbeg.resize(ncols + 1);
+    matval.resize(val_beg.back());
+
+    cav::parallel_for_chunks(chunks.size(), nthreads, [&](size_t c) {
+        const ChunkData& d = data[c];
+        size_t beg = val_beg[c];
+        for (size_t k = 0; k < d.costs.size(); ++k) {
+            costs[col_beg[c] + k] = d.costs[k];
+            matbeg[col_beg[c] + k] = static_cast<int>(beg);
+            beg += d.counts[k];
+        }
+        std::copy(d.rows.begin(), d.rows.end(), matval.begin() + val_beg[c]);
+    });
+    matbeg[ncols] = static_cast<int>(matval.size());
+
+    inst.nrows = static_cast<int>(nrows);
+    inst.solcosts = costs;
+    return inst;
 }
 
 #endif
@@ -0,0 +1,70 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CircularVector.hpp"
+
+using Graph = std::vector<std::vector<int>>;
+
+static Graph make_random_graph(int nnodes, int degree, unsigned seed) {
+    std::mt19937 rnd(seed);
+    std::uniform_int_distribution<int> dist(0, nnodes - 1);
+    Graph g(nnodes);
+    for (int u = 0; u < nnodes; ++u) {
+        for (int k = 0; k < degree; ++k) { g[u].emplace_back(dist(rnd)); }
+    }
+    return g;
+}
+
+// BFS levels from src, the queue is the only thing changing between the two versions.
+template <typename Queue>
+static long bfs(const Graph& g, int src, std::vector<int>& level, Queue& Q) {
+    std::fill(level.begin(), level.end(), -1);
+    level[src] = 0;
+    Q.push_back(src);
+
+    long checksum = 0;
+    while (!Q.empty()) {
+        const int u = Q.front();
+        Q.pop_front();
+        checksum += level[u];
+        for (int n : g[u]) {
+            if (level[n] < 0) {
+                level[n] = level[u] + 1;
+                Q.push_back(n);
+            }
+        }
+    }
+    return checksum;
+}
+
+template <typename Queue>
+static void run(const char* name, const Graph& g, int nruns) {
+    std::vector<int> level(g.size());
+    Queue Q;
+    long checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < nruns; ++r) { checksum += bfs(g, r % g.size(), level, Q); }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fmt::print("{:<20} {:>10.3f} ms/bfs  (checksum {})\n", name, elapsed * 1000.0 / nruns, checksum);
+}
+
+int main(int argc, char** argv) {
+    const int nnodes = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    const int degree = argc > 2 ? std::stoi(argv[2]) : 4;
+    const int nruns = argc > 3 ? std::stoi(argv[3]) : 20;
+
+    auto g = make_random_graph(nnodes, degree, 0);
+    fmt::print("BFS queue benchmark: {} nodes, degree {}, {} runs\n", nnodes, degree, nruns);
+
+    run<std::deque<int>>("std::deque", g, nruns);
+    run<cav::CircularVector<int>>("cav::CircularVector", g, nruns);
+
+    return 0;
+}
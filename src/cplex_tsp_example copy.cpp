@@ -4,7 +4,10 @@ extern "C" {
 #include "../concorde/concorde.h"
 }
 
+#include <vector>
+
 #include "TSP.hpp"
+#include "ThreadPool.hpp"
 
 #define PURGEABLE CPX_USECUT_FILTER
 #define EPSILON 1E-6
@@ -18,9 +21,10 @@ struct generic_input {
         double *ones_for_cplex;
         CPXCALLBACKCONTEXTptr context;
         int ncuts;
-        double *xstar;
-        int *rmatind;
-    } * l;
+        std::vector<double> xstar;
+        std::vector<int> rmatind;
+    };
+    cav::WorkerLocal<t_local> l = cav::WorkerLocal<t_local>(size_t(0));  // indexed by CPLEX thread id
 };
 
 int generic_doit_fn_concorde([[maybe_unused]] double cutval, int nnodescut, int *cut, void *in) {
@@ -32,7 +36,7 @@ int generic_doit_fn_concorde([[maybe_unused]] double cutval, int nnodescut, int
     }
 
     TSPInstance *inst = datal->inst;
-    int *rmatind = datal->rmatind;
+    int *rmatind = datal->rmatind.data();
 
     int nnz = 0, rmatbeg = 0;
     char sense = 'L';
@@ -52,7 +56,7 @@ int generic_doit_fn_concorde([[maybe_unused]] double cutval, int nnodescut, int
 
 int generic_addSec_concorde_frac(generic_input *data, double *xstar, CPXCALLBACKCONTEXTptr context, int t) {
     TSPInstance &inst = *data->inst;
-    int *rmatind = data->l[t].rmatind;
+    int *rmatind = data->l[t].rmatind.data();
     int ncomp = 0, nsec = 0, *compscount = NULL, *comps = NULL;
 
     // find connected component with concorde
@@ -62,7 +66,7 @@ int generic_addSec_concorde_frac(generic_input *data, double *xstar, CPXCALLBACK
     if (ncomp == 1) {
         data->l[t].context = context;
         data->l[t].ncuts = 0;
-        if (CCcut_violated_cuts(inst.dimension, inst.ecount, inst.elist, xstar, 2.0 - EPSILON, generic_doit_fn_concorde, (void *)data->l))
+        if (CCcut_violated_cuts(inst.dimension, inst.ecount, inst.elist, xstar, 2.0 - EPSILON, generic_doit_fn_concorde, (void *)&data->l[t]))
             fmt::print(stderr, "Error in CCcut_violated_cuts");
         nsec = data->l[t].ncuts;
 
@@ -90,7 +94,7 @@ int generic_addSec_concorde_frac(generic_input *data, double *xstar, CPXCALLBACK
 
 int generic_addSec_concorde(generic_input *data, double *xstar, CPXCALLBACKCONTEXTptr context, int t) {
     TSPInstance &inst = *data->inst;
-    int *rmatind = data->l[t].rmatind;
+    int *rmatind = data->l[t].rmatind.data();
     int ncomp = 0, *compscount = NULL, *comps = NULL;
 
     // find connected component with concorde
@@ -126,7 +130,7 @@ static int CPXPUBLIC my_generic_lazycallback(CPXCALLBACKCONTEXTptr context, [[ma
 
     // get solution
     double objval = CPX_INFBOUND;
-    double *xstar = data->l[mythread].xstar;
+    double *xstar = data->l[mythread].xstar.data();
     if (CPXcallbackgetcandidatepoint(context, xstar, 0, inst.ecount - 1, &objval)) fmt::print(stderr, "Error get node in callback");
 
     // apply cut separator and possibly add violated cuts
@@ -179,7 +183,7 @@ static int CPXPUBLIC my_generic_usrcallback(CPXCALLBACKCONTEXTptr context, [[may
 
     // get solution
     double objval = CPX_INFBOUND;
-    double *xstar = data->l[mythread].xstar;
+    double *xstar = data->l[mythread].xstar.data();
     if (CPXcallbackgetrelaxationpoint(context, xstar, 0, inst.ecount - 1, &objval)) fmt::print(stderr, "Error get node in callback");
 
     // apply cut separator and possibly add violated cuts
@@ -221,12 +225,12 @@ void generic_usrcallback_solve(TSPInstance &inst, CPXENVptr env, CPXLPptr lp) {
     data.inst = &inst;
     data.ones_for_cplex = new double[inst.ecount];
     std::fill(data.ones_for_cplex, data.ones_for_cplex + inst.ecount, 1.0);
-    data.l = new generic_input::t_local[ncores];
+    data.l = cav::WorkerLocal<generic_input::t_local>(ncores);
     for (int i = 0; i < ncores; ++i) {
         data.l[i].inst = data.inst;
         data.l[i].ones_for_cplex = data.ones_for_cplex;
-        data.l[i].rmatind = new int[inst.ecount];
-        data.l[i].xstar = new double[inst.ecount];
+        data.l[i].rmatind.resize(inst.ecount);
+        data.l[i].xstar.resize(inst.ecount);
     }
 
     CPXcallbacksetfunc(env, lp, CPX_CALLBACKCONTEXT_RELAXATION | CPX_CALLBACKCONTEXT_CANDIDATE, my_generic_callback, &data);
@@ -244,11 +248,6 @@ void generic_usrcallback_solve(TSPInstance &inst, CPXENVptr env, CPXLPptr lp) {
 
     CPXcallbacksetfunc(env, lp, CPX_CALLBACKCONTEXT_RELAXATION | CPX_CALLBACKCONTEXT_CANDIDATE, NULL, &data);
 
-    for (int i = 0; i < ncores; ++i) {
-        delete[] data.l[i].xstar;
-        delete[] data.l[i].rmatind;
-    }
-    delete[] data.l;
     delete[] data.ones_for_cplex;
 }
 
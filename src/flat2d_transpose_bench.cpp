@@ -0,0 +1,45 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "Flat2DParallel.hpp"
+#include "Flat2DVector.hpp"
+
+template <typename Func>
+static double time_ms(Func&& f, int nruns) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < nruns; ++r) { f(); }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / nruns;
+}
+
+static void naive_transpose(const cav::Flat2DVector<double>& src, cav::Flat2DVector<double>& dst) {
+    for (size_t i = 0; i < src.get_rows(); ++i) {
+        for (size_t j = 0; j < src.get_cols(); ++j) { dst.at(j, i) = src.at(i, j); }
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t nrows = argc > 1 ? std::stoul(argv[1]) : 4000;
+    const size_t ncols = argc > 2 ? std::stoul(argv[2]) : 4000;
+    const int nruns = argc > 3 ? std::stoi(argv[3]) : 5;
+    const unsigned nthreads = std::thread::hardware_concurrency();
+
+    cav::Flat2DVector<double> src(nrows, ncols);
+    for (size_t i = 0; i < nrows; ++i) {
+        for (size_t j = 0; j < ncols; ++j) { src.at(i, j) = static_cast<double>(i * ncols + j); }
+    }
+    cav::Flat2DVector<double> dst(ncols, nrows);
+
+    fmt::print("Transpose benchmark: {}x{} doubles, {} runs, {} threads\n", nrows, ncols, nruns, nthreads);
+    fmt::print("{:<24} {:>10.3f} ms\n", "naive", time_ms([&]() { naive_transpose(src, dst); }, nruns));
+    fmt::print("{:<24} {:>10.3f} ms\n", "tiled", time_ms([&]() { src.transpose_into(dst); }, nruns));
+    fmt::print("{:<24} {:>10.3f} ms\n", "tiled parallel", time_ms([&]() { cav::parallel_transpose_into(src, dst, nthreads); }, nruns));
+    if (nrows == ncols) {
+        fmt::print("{:<24} {:>10.3f} ms\n", "tiled in-place", time_ms([&]() { src.transpose(); }, nruns));
+        fmt::print("{:<24} {:>10.3f} ms\n", "tiled in-place parallel", time_ms([&]() { cav::parallel_transpose(src, nthreads); }, nruns));
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryHeap.hpp"
+#include "MultiQueue.hpp"
+
+struct IntCmp {
+    int operator()(int a, int b) const { return a - b; }
+};
+
+// Baseline: a single BinaryHeap behind a mutex, with the same interface of MultiQueue.
+class LockedHeap {
+public:
+    explicit LockedHeap(size_t) { }
+
+    template <class F>
+    void push(int key, F&& on_push) {
+        std::lock_guard<std::mutex> lock(mtx);
+        on_push(key);
+        heap.insert(key);
+    }
+
+    template <class F>
+    bool try_pop(int& out, F&& on_pop) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (heap.empty()) { return false; }
+        out = heap.get();
+        on_pop(out);
+        return true;
+    }
+
+private:
+    std::mutex mtx;
+    cav::BinaryHeap<int, IntCmp, cav::NoHeapIdx, cav::NoHeapIdx, cav::NoHeapIdx> heap;
+};
+
+struct Event {
+    uint64_t ticket;
+    int key;
+    bool pop;
+};
+
+struct Result {
+    double mops;
+    double mean_rank;
+    long max_rank;
+};
+
+// Count of the keys present in the queue (Fenwick tree), used to replay the log and compute the rank of each pop.
+class KeyCounter {
+public:
+    explicit KeyCounter(int nkeys) : tree(nkeys + 1, 0) { }
+
+    void add(int key, int v) {
+        for (int i = key + 1; i < static_cast<int>(tree.size()); i += i & -i) { tree[i] += v; }
+    }
+
+    // number of keys < key
+    long count_less(int key) const {
+        long res = 0;
+        for (int i = key; i > 0; i -= i & -i) { res += tree[i]; }
+        return res;
+    }
+
+private:
+    std::vector<long> tree;
+};
+
+/**
+ * Every thread alternates one pop and one push of a random key. With log=true each operation takes a global ticket
+ * while holding the heap lock, so the log is a valid linearization and the rank error can be computed offline.
+ */
+template <typename Queue, bool log>
+static Result run(int nthreads, int nops, int prefill, int nkeys) {
+    Queue Q(nthreads);
+    std::atomic<uint64_t> ticket{0};
+    std::vector<std::vector<Event>> logs(nthreads);
+
+    auto log_push = [&](std::vector<Event>& l) {
+        return [&ticket, lp = &l](int key) {
+            if constexpr (log) { lp->push_back({ticket.fetch_add(1, std::memory_order_relaxed), key, false}); }
+        };
+    };
+    auto log_pop = [&](std::vector<Event>& l) {
+        return [&ticket, lp = &l](int key) {
+            if constexpr (log) { lp->push_back({ticket.fetch_add(1, std::memory_order_relaxed), key, true}); }
+        };
+    };
+
+    std::mt19937 rnd(0);
+    for (int k = 0; k < prefill; ++k) { Q.push(static_cast<int>(rnd() % nkeys), log_push(logs[0])); }
+
+    auto worker = [&](int tid) {
+        std::mt19937 trnd(tid + 1);
+        std::vector<Event>& l = logs[tid];
+        if constexpr (log) { l.reserve(l.size() + 2 * nops); }
+        int key;
+        for (int k = 0; k < nops; ++k) {
+            Q.try_pop(key, log_pop(l));
+            Q.push(static_cast<int>(trnd() % nkeys), log_push(l));
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) { threads.emplace_back(worker, t); }
+    for (auto& th : threads) { th.join(); }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Result res = {2.0 * nthreads * nops / secs / 1e6, 0.0, 0};
+    if constexpr (log) {
+        std::vector<Event> all;
+        for (auto& l : logs) { all.insert(all.end(), l.begin(), l.end()); }
+        std::sort(all.begin(), all.end(), [](const Event& a, const Event& b) { return a.ticket < b.ticket; });
+
+        KeyCounter present(nkeys);
+        long npops = 0;
+        double tot_rank = 0.0;
+        for (const Event& e : all) {
+            if (e.pop) {
+                const long rank = present.count_less(e.key);
+                tot_rank += rank;
+                res.max_rank = std::max(res.max_rank, rank);
+                ++npops;
+            }
+            present.add(e.key, e.pop ? -1 : 1);
+        }
+        res.mean_rank = npops > 0 ? tot_rank / npops : 0.0;
+    }
+    return res;
+}
+
+int main(int argc, char** argv) {
+    const int max_threads = argc > 1 ? std::stoi(argv[1]) : 64;
+    const int nops = argc > 2 ? std::stoi(argv[2]) : 200000;
+    const int prefill = argc > 3 ? std::stoi(argv[3]) : 1 << 16;
+    constexpr int nkeys = 1 << 20;
+
+    using MQ = cav::MultiQueue<int, IntCmp>;
+
+    fmt::print("Concurrent priority queue benchmark: {} pop+push per thread, {} prefilled keys\n", nops, prefill);
+    fmt::print("{:>8} {:>14} {:>14} {:>12} {:>12}\n", "threads", "mutex Mops/s", "MQ Mops/s", "MQ mean rank", "MQ max rank");
+    for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2) {
+        const Result locked = run<LockedHeap, false>(nthreads, nops, prefill, nkeys);
+        const Result mq = run<MQ, false>(nthreads, nops, prefill, nkeys);
+        const Result mq_quality = run<MQ, true>(nthreads, nops, prefill, nkeys);
+        fmt::print("{:>8} {:>14.2f} {:>14.2f} {:>12.1f} {:>12}\n", nthreads, locked.mops, mq.mops, mq_quality.mean_rank, mq_quality.max_rank);
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryHeap.hpp"
+#include "ObjectPool.hpp"
+
+struct Node {
+    Node(int edge_, double dist_) : edge(edge_), hidx(-1), dist(dist_) { }
+    int edge, hidx;
+    double dist;
+};
+
+// Every thread repeatedly allocates a batch of nodes, pushes them into a heap, then frees them.
+template <typename New, typename Delete>
+static double run(int nthreads, int nrounds, int batch, New&& new_node, Delete&& delete_node) {
+    auto worker = [&]() {
+        cav::BinaryHeapPtr<Node, &Node::hidx, &Node::dist> Q;
+        std::vector<Node*> nodes(batch);
+        for (int r = 0; r < nrounds; ++r) {
+            for (int k = 0; k < batch; ++k) {
+                nodes[k] = new_node(k, static_cast<double>((k * 7919) % batch));
+                Q.insert(nodes[k]);
+            }
+            while (!Q.empty()) { delete_node(Q.get()); }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) { threads.emplace_back(worker); }
+    for (auto& th : threads) { th.join(); }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(nthreads) * nrounds * batch / secs / 1e6;
+}
+
+int main(int argc, char** argv) {
+    const int nthreads = argc > 1 ? std::stoi(argv[1]) : 32;
+    const int nrounds = argc > 2 ? std::stoi(argv[2]) : 200;
+    const int batch = argc > 3 ? std::stoi(argv[3]) : 4096;
+
+    cav::ObjectPool<Node> pool;
+
+    fmt::print("Node allocation benchmark: {} threads, {} rounds of {} nodes\n", nthreads, nrounds, batch);
+    const double mnew = run(
+        nthreads, nrounds, batch, [](int e, double d) { return new Node(e, d); }, [](Node* n) { delete n; });
+    fmt::print("{:<20} {:>10.2f} Mnodes/s\n", "new/delete", mnew);
+
+    const double mpool = run(
+        nthreads, nrounds, batch, [&](int e, double d) { return pool.create(e, d); }, [&](Node* n) { pool.destroy(n); });
+    fmt::print("{:<20} {:>10.2f} Mnodes/s ({} slabs)\n", "cav::ObjectPool", mpool, pool.slab_count());
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "TSP.hpp"
+#include "parsing.hpp"
+
+// Random rail-like instance: "nrows ncols", then one "cost nrows_j rows..." line per column.
+static void write_rail(const std::string& path, int nrows, int ncols, unsigned seed) {
+    std::mt19937 rnd(seed);
+    std::ofstream out(path);
+    out << nrows << " " << ncols << "\n";
+    for (int j = 0; j < ncols; ++j) {
+        const int jrows = 1 + rnd() % 10;
+        out << 1 + rnd() % 3 << " " << jrows;
+        for (int n = 0; n < jrows; ++n) { out << " " << 1 + rnd() % nrows; }
+        out << "\n";
+    }
+}
+
+static void write_tsp(const std::string& path, int dimension, unsigned seed) {
+    std::mt19937 rnd(seed);
+    std::uniform_real_distribution<double> coord(0.0, 1e5);
+    std::ofstream out(path);
+    out << "NAME : synthetic\nTYPE : TSP\nDIMENSION : " << dimension << "\nEDGE_WEIGHT_TYPE : EUC_2D\nNODE_COORD_SECTION\n";
+    out.precision(10);
+    for (int i = 0; i < dimension; ++i) { out << i + 1 << " " << coord(rnd) << " " << coord(rnd) << "\n"; }
+    out << "EOF\n";
+}
+
+template <typename Func>
+static double time_ms(Func&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const unsigned nthreads = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    const int ncols = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    const std::string rail_path = "/tmp/cav_parallel_parse_bench.rail";
+    const std::string tsp_path = "/tmp/cav_parallel_parse_bench.tsp";
+
+    write_rail(rail_path, ncols / 50, ncols, 0);
+    InstanceData seq, par;
+    const double seq_ms = time_ms([&] { seq = parse_rail_instance(rail_path); });
+    const double par_ms = time_ms([&] { par = parse_rail_instance_parallel(rail_path, nthreads); });
+    const bool rail_equal = seq.nrows == par.nrows && seq.costs == par.costs && seq.matbeg == par.matbeg && seq.matval == par.matval;
+    fmt::print("rail, {} columns, {} nonzeros: sequential {:.1f} ms, {} threads {:.1f} ms, identical: {}\n", ncols, seq.matval.size(), seq_ms,
+               nthreads, par_ms, rail_equal);
+
+    // Small enough for the O(n^2) edge list that both constructors build, only the coordinates are compared.
+    const int dimension = 3000;
+    write_tsp(tsp_path, dimension, 1);
+    bool tsp_equal = true;
+    {
+        const auto tsp_seq = TSPInstance(tsp_path);
+        const auto tsp_par = TSPInstance(tsp_path, std::allocator<int>(), nthreads);
+        for (int i = 0; i < dimension; ++i) {
+            tsp_equal &= tsp_seq.customers[i].x == tsp_par.customers[i].x && tsp_seq.customers[i].y == tsp_par.customers[i].y;
+        }
+    }
+    fmt::print("tsp, {} nodes: identical coordinates: {}\n", dimension, tsp_equal);
+
+    std::remove(rail_path.c_str());
+    std::remove(tsp_path.c_str());
+    return rail_equal && tsp_equal ? 0 : 1;
+}
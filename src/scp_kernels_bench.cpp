@@ -0,0 +1,86 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "ContainerJitMap.hpp"
+#include "ScpKernels.hpp"
+#include "parsing.hpp"
+
+// Random rail-like matrix: 1 to 10 rows per column.
+static InstanceData random_instance(int nrows, int ncols, unsigned seed) {
+    std::mt19937 rnd(seed);
+    InstanceData inst;
+    inst.nrows = nrows;
+    inst.matbeg.push_back(0);
+    for (int j = 0; j < ncols; ++j) {
+        const int jrows = 1 + rnd() % 10;
+        for (int n = 0; n < jrows; ++n) { inst.matval.push_back(rnd() % nrows); }
+        inst.matbeg.push_back(inst.matval.size());
+        inst.costs.push_back(1 + rnd() % 3);
+    }
+    return inst;
+}
+
+template <typename Func>
+static double time_ms(Func&& f, int reps) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) { f(); }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    // argv[1]: a rail instance, otherwise a random one with argv[2] columns
+    const int ncols_arg = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    const auto inst = argc > 1 && std::string(argv[1]) != "-" ? parse_rail_instance(argv[1]) : random_instance(4000, ncols_arg, 0);
+    const size_t nrows = inst.nrows, ncols = inst.costs.size();
+    const int reps = 10;
+
+    std::mt19937 rnd(1);
+    auto u = std::vector<double>(nrows);
+    for (auto& ui : u) { ui = (rnd() % 1000) / 1000.0; }
+    auto x = std::vector<double>(ncols);
+    for (auto& xj : x) { xj = rnd() % 20 == 0 ? 1.0 : 0.0; }
+
+    auto rc_ref = std::vector<double>(ncols), rc = std::vector<double>(ncols);
+    const double rc_ref_ms = time_ms([&] {
+        for (size_t j = 0; j < ncols; ++j) {
+            double s = inst.costs[j];
+            for (int k = inst.matbeg[j]; k < inst.matbeg[j + 1]; ++k) { s -= u[inst.matval[k]]; }
+            rc_ref[j] = s;
+        }
+    }, reps);
+    const double rc_ms = time_ms([&] { cav::csc_reduced_costs(inst, u.data(), rc.data()); }, reps);
+
+    auto cov_ref = std::vector<double>(nrows), cov = std::vector<double>(nrows);
+    const double cov_ref_ms = time_ms([&] {
+        std::fill(cov_ref.begin(), cov_ref.end(), 0.0);
+        for (size_t j = 0; j < ncols; ++j) {
+            for (int k = inst.matbeg[j]; k < inst.matbeg[j + 1]; ++k) { cov_ref[inst.matval[k]] += x[j]; }
+        }
+    }, reps);
+    cav::BinaryCsr csr;
+    const double csr_ms = time_ms([&] { csr = cav::csc_to_csr(inst); }, reps);
+    const double cov_ms = time_ms([&] { cav::csr_row_coverage(csr, x.data(), cov.data()); }, reps);
+
+    bool equal = true;
+    for (size_t j = 0; j < ncols; ++j) { equal &= std::abs(rc[j] - rc_ref[j]) < 1e-9; }
+    for (size_t i = 0; i < nrows; ++i) { equal &= std::abs(cov[i] - cov_ref[i]) < 1e-9; }
+
+    // Lagrangian bound sum(u) + sum(min(rc, 0)): the same (up to rounding) whatever the number of threads
+    const double sum_u = std::accumulate(u.begin(), u.end(), 0.0);
+    auto neg_rc = cav::make_lazy(rc).map([](double r) { return std::min(r, 0.0); });
+    const double lb_1 = cav::parallel_reduce(neg_rc, sum_u, std::plus<>(), 1);
+    const double lb_n = cav::parallel_reduce(neg_rc, sum_u, std::plus<>(), 8);
+    equal &= std::abs(lb_1 - lb_n) <= 1e-9 * std::max(1.0, std::abs(lb_1));
+
+    fmt::print("{} rows, {} columns, {} nonzeros, {} threads\n", nrows, ncols, inst.matval.size(), cav::default_nthreads());
+    fmt::print("reduced costs:  plain loop {:.2f} ms, kernel {:.2f} ms\n", rc_ref_ms, rc_ms);
+    fmt::print("row coverage:   CSC scatter {:.2f} ms, CSR gather {:.2f} ms (+ {:.2f} ms transpose, once)\n", cov_ref_ms, cov_ms, csr_ms);
+    fmt::print("Lagrangian bound: {:.6f} (1 thread), {:.6f} (8 threads)\n", lb_1, lb_n);
+    fmt::print("results match: {}\n", equal);
+    return equal ? 0 : 1;
+}
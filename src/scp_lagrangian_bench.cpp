@@ -0,0 +1,32 @@
+#include <fmt/core.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ScpLagrangian.hpp"
+#include "parsing.hpp"
+
+#ifndef INSTANCES_DIR
+#define INSTANCES_DIR "instances"
+#endif
+
+int main(int argc, char** argv) {
+    // argv: instance files (rail format if the name contains "rail"), the repository ones by default
+    auto paths = std::vector<std::string>(argv + 1, argv + argc);
+    if (paths.empty()) { paths = {INSTANCES_DIR "/scp/scp41.txt", INSTANCES_DIR "/scp/scp52.txt", INSTANCES_DIR "/scp/rail516"}; }
+
+    for (const auto& path : paths) {
+        const auto is_rail = path.find("rail") != std::string::npos;
+        const auto inst = is_rail ? parse_rail_instance(path) : parse_scp_instance(path);
+
+        const auto start = std::chrono::steady_clock::now();
+        auto lagr = cav::ScpLagrangian(inst);
+        const auto res = lagr.solve();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        fmt::print("{}: {} rows, {} columns | LB {:.3f}, greedy UB {} {}| {} iterations, {} pricings, {:.1f} ms\n", path.substr(path.find_last_of('/') + 1),
+                   inst.nrows, inst.costs.size(), res.lower_bound, res.solution_cost, res.optimal ? "(optimal) " : "", res.iterations, res.pricings, ms);
+    }
+    return 0;
+}